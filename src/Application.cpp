@@ -1,4 +1,6 @@
 #include "Application.h"
+#include "Render/RiverNetworkDebug.h"
+#include "Render/TensorFieldDebug.h"
 #include "raymath.h"
 #include "rlgl.h"
 
@@ -91,11 +93,158 @@ Application::Application() {
             #version 330
             in vec4 fragColor;
             out vec4 finalColor;
+            uniform vec4 colDiffuse;
             void main() {
-                finalColor = fragColor;
+                finalColor = fragColor * colDiffuse;
             }
         )";
   unlitShader = LoadShaderFromMemory(unlitVs, unlitFs);
+
+  // Packed chunk meshes (TerrainMesh::Settings::packedVertices): decode the
+  // 16-bit height, octahedral normal and palette index, then hand the same
+  // outputs as the float vertex shaders to the lit/unlit fragment shaders.
+  // X and Z come from the vertex index within the chunk grid.
+  const char *packedVs = R"(
+            #version 330
+            layout(location = 0) in float vertexHeight;
+            layout(location = 1) in vec4 vertexPacked;
+            out vec3 fragPosition;
+            out vec2 fragTexCoord;
+            out vec4 fragColor;
+            out vec3 fragNormal;
+            uniform mat4 mvp;
+            uniform mat4 matModel;
+            uniform int chunkVerts;
+            uniform ivec2 chunkOrigin;
+            uniform ivec2 terrainSize;
+            uniform float heightScale;
+            uniform vec4 palette[6];
+            vec3 DecodeOctahedral(vec2 e) {
+                vec2 p = e * 2.0 - 1.0;
+                vec3 n = vec3(p.x, 1.0 - abs(p.x) - abs(p.y), p.y);
+                if (n.y < 0.0)
+                    n.xz = (1.0 - abs(n.zx)) * sign(n.xz);
+                return normalize(n);
+            }
+            void main() {
+                ivec2 local = ivec2(gl_VertexID % chunkVerts, gl_VertexID / chunkVerts);
+                // Padding vertices of the last chunk row/column repeat the edge
+                ivec2 cell = min(chunkOrigin + local, terrainSize - 1);
+                vec3 position = vec3(float(cell.x), vertexHeight * heightScale, float(cell.y));
+                fragPosition = vec3(matModel * vec4(position, 1.0));
+                fragTexCoord = vec2(0.0);
+                fragColor = palette[int(vertexPacked.z * 255.0 + 0.5)];
+                fragNormal = DecodeOctahedral(vertexPacked.xy);
+                gl_Position = mvp * vec4(position, 1.0);
+            }
+        )";
+  packedLightingShader = LoadShaderFromMemory(packedVs, fs);
+  packedUnlitShader = LoadShaderFromMemory(packedVs, unlitFs);
+
+  SetShaderValue(packedLightingShader,
+                 GetShaderLocation(packedLightingShader, "lightDir"),
+                 &lightDir, SHADER_UNIFORM_VEC3);
+  SetShaderValue(packedLightingShader,
+                 GetShaderLocation(packedLightingShader, "lightColor"),
+                 &lightColor, SHADER_UNIFORM_VEC4);
+  SetShaderValue(packedLightingShader,
+                 GetShaderLocation(packedLightingShader, "ambientColor"),
+                 &ambientColor, SHADER_UNIFORM_VEC4);
+
+  // GPU displacement: a flat chunk grid lifted from the height texture, with
+  // the terrain palette (TerrainMesh::GetPaletteIndex) evaluated per
+  // fragment. Height scale and sea level are uniforms, so slider changes show
+  // up without a mesh rebuild.
+  const char *displacedVs = R"(
+            #version 330
+            in vec2 vertexPosition;
+            out vec3 fragNormal;
+            out float fragHeight;
+            out float fragRiver;
+            uniform mat4 mvp;
+            uniform sampler2D heightMap;
+            uniform sampler2D riverMap;
+            uniform ivec2 terrainSize;
+            uniform ivec2 chunkOrigin;
+            uniform float heightScale;
+            uniform float cellSize;
+            float GetHeight(ivec2 p) {
+                if (any(lessThan(p, ivec2(0))) || any(greaterThanEqual(p, terrainSize)))
+                    return 0.0;
+                return texelFetch(heightMap, p, 0).r;
+            }
+            void main() {
+                // Padding vertices of the last chunk row/column repeat the edge
+                ivec2 cell = min(chunkOrigin + ivec2(vertexPosition), terrainSize - 1);
+                float h = GetHeight(cell);
+                float hL = GetHeight(cell - ivec2(1, 0)) * heightScale;
+                float hR = GetHeight(cell + ivec2(1, 0)) * heightScale;
+                float hD = GetHeight(cell - ivec2(0, 1)) * heightScale;
+                float hU = GetHeight(cell + ivec2(0, 1)) * heightScale;
+                fragNormal = normalize(cross(vec3(0.0, hU - hD, 2.0 * cellSize),
+                                             vec3(2.0 * cellSize, hR - hL, 0.0)));
+                fragHeight = h;
+                fragRiver = texelFetch(riverMap, cell, 0).r > 0.0 ? 1.0 : 0.0;
+                gl_Position = mvp * vec4(float(cell.x), h * heightScale, float(cell.y), 1.0);
+            }
+        )";
+  const char *displacedFs = R"(
+            #version 330
+            in vec3 fragNormal;
+            in float fragHeight;
+            in float fragRiver;
+            out vec4 finalColor;
+            uniform float seaLevel;
+            uniform int lighting;
+            uniform vec3 lightDir;
+            uniform vec4 lightColor;
+            uniform vec4 ambientColor;
+            uniform vec4 colDiffuse;
+            uniform vec4 palette[6];
+            // Same bands as TerrainMesh::GetPaletteIndex
+            int GetPaletteIndex(float h) {
+                if (h < seaLevel) return 0;
+                if (h < seaLevel + 0.05) return 1;
+                if (h < 0.6) return 2;
+                if (h < 0.8) return 3;
+                return 4;
+            }
+            void main() {
+                vec4 color = mix(palette[GetPaletteIndex(fragHeight)], palette[5], fragRiver);
+                if (lighting != 0) {
+                    float NdotL = max(dot(normalize(fragNormal), -lightDir), 0.0);
+                    color *= ambientColor + lightColor * NdotL;
+                }
+                finalColor = color * colDiffuse;
+            }
+        )";
+  displacedShader = LoadShaderFromMemory(displacedVs, displacedFs);
+  displacedLightingLoc = GetShaderLocation(displacedShader, "lighting");
+  SetShaderValue(displacedShader,
+                 GetShaderLocation(displacedShader, "lightDir"), &lightDir,
+                 SHADER_UNIFORM_VEC3);
+  SetShaderValue(displacedShader,
+                 GetShaderLocation(displacedShader, "lightColor"), &lightColor,
+                 SHADER_UNIFORM_VEC4);
+  SetShaderValue(displacedShader,
+                 GetShaderLocation(displacedShader, "ambientColor"),
+                 &ambientColor, SHADER_UNIFORM_VEC4);
+
+  // One palette for every terrain shader (the displaced one has no
+  // chunkVerts; raylib skips the missing location)
+  using Render::TerrainMesh;
+  Vector4 palette[TerrainMesh::PaletteSize];
+  for (int i = 0; i < TerrainMesh::PaletteSize; i++)
+    palette[i] = ColorNormalize(TerrainMesh::Palette[i]);
+  int chunkVerts = TerrainMesh::ChunkVerts;
+
+  for (Shader shader :
+       {packedLightingShader, packedUnlitShader, displacedShader}) {
+    SetShaderValueV(shader, GetShaderLocation(shader, "palette"), palette,
+                    SHADER_UNIFORM_VEC4, TerrainMesh::PaletteSize);
+    SetShaderValue(shader, GetShaderLocation(shader, "chunkVerts"),
+                   &chunkVerts, SHADER_UNIFORM_INT);
+  }
 }
 
 void Application::ResetCamera() {
@@ -158,8 +307,13 @@ void Application::UpdateCustomCamera() {
 }
 
 Application::~Application() {
+  terrainRenderer.Unload();
+  terrainMesh.Unload();
   UnloadShader(lightingShader);
   UnloadShader(unlitShader);
+  UnloadShader(packedLightingShader);
+  UnloadShader(packedUnlitShader);
+  UnloadShader(displacedShader);
   rlImGuiShutdown();
   CloseWindow();
 }
@@ -174,29 +328,59 @@ void Application::Run() {
       currentRenderMode = RenderMode::Lit;
     if (IsKeyPressed(KEY_F3))
       currentRenderMode = RenderMode::Wireframe;
+    if (IsKeyPressed(KEY_F4))
+      terrainRenderer.settings.gpuDisplacement =
+          !terrainRenderer.settings.gpuDisplacement;
+    if (IsKeyPressed(KEY_F5))
+      terrainRenderer.settings.lod = !terrainRenderer.settings.lod;
+    if (IsKeyPressed(KEY_F6))
+      terrainRenderer.settings.frustumCulling =
+          !terrainRenderer.settings.frustumCulling;
     if (IsKeyPressed(KEY_R))
       ResetCamera();
 
+    // Picks up whatever the generators changed since the last frame
+    terrainMesh.settings.displayOnGpu =
+        terrainRenderer.settings.gpuDisplacement;
+    terrainMesh.Update(*world->terrain);
+
     BeginDrawing();
     ClearBackground(Color{30, 30, 30, 255});
 
     BeginMode3D(camera);
     DrawGrid(200, 1.0f);
 
-    if (world->terrain->isModelLoaded) {
-      Model &model = world->terrain->model;
+    if (terrainRenderer.settings.gpuDisplacement) {
+      // Height and sea level come straight from the wizard's sliders
+      const auto &config = wizard.GetTerrainConfig();
+      Render::TerrainRenderer::DisplacementParams params;
+      params.heightMultiplier = config.heightMultiplier;
+      params.seaLevel = config.seaLevel;
+
+      int lighting = currentRenderMode == RenderMode::Lit ? 1 : 0;
+      SetShaderValue(displacedShader, displacedLightingLoc, &lighting,
+                     SHADER_UNIFORM_INT);
+      bool wireframe = currentRenderMode == RenderMode::Wireframe;
+      terrainRenderer.DrawDisplaced(*world->terrain, terrainMesh, camera,
+                                    displacedShader, params,
+                                    wireframe ? GREEN : WHITE, wireframe);
+    } else {
+      bool packed = terrainMesh.packed;
+      Shader lit = packed ? packedLightingShader : lightingShader;
+      Shader unlit = packed ? packedUnlitShader : unlitShader;
       if (currentRenderMode == RenderMode::Lit) {
-        model.materials[0].shader = lightingShader;
-        DrawModel(model, {0, 0, 0}, 1.0f, WHITE);
+        terrainRenderer.Draw(terrainMesh, camera, lit, WHITE, false);
       } else if (currentRenderMode == RenderMode::Unlit) {
-        model.materials[0].shader = unlitShader;
-        DrawModel(model, {0, 0, 0}, 1.0f, WHITE);
+        terrainRenderer.Draw(terrainMesh, camera, unlit, WHITE, false);
       } else if (currentRenderMode == RenderMode::Wireframe) {
-        DrawModelWires(model, {0, 0, 0}, 1.0f, GREEN);
+        terrainRenderer.Draw(terrainMesh, camera, unlit, GREEN, true);
       }
     }
 
-    world->tensorField->DrawDebug(0.1f);
+    Render::DrawTensorFieldDebug(*world->tensorField, 0.1f);
+    if (showRiverNetwork && world->riverNetwork)
+      Render::DrawRiverNetworkDebug(*world->riverNetwork,
+                                    world->terrain->heightMultiplier);
     EndMode3D();
 
     rlImGuiBegin();
@@ -214,7 +398,25 @@ void Application::Run() {
     ImGui::Text("R: Reset Camera");
     ImGui::Separator();
     ImGui::Text("F1: Unlit  F2: Lit  F3: Wireframe");
+    ImGui::Text("F4: GPU Displacement (%s)",
+                terrainRenderer.settings.gpuDisplacement ? "on" : "off");
+    ImGui::Text("F5: LOD (%s)  F6: Culling (%s)",
+                terrainRenderer.settings.lod ? "on" : "off",
+                terrainRenderer.settings.frustumCulling ? "on" : "off");
+    const auto &stats = terrainRenderer.GetStats();
+    ImGui::Text("Chunks: %d / %d  Tris: %d", stats.chunksDrawn,
+                stats.chunksTotal, stats.trianglesDrawn);
+    ImGui::Separator();
+    auto &meshSettings = terrainMesh.settings;
+    ImGui::Checkbox("Packed Vertices", &meshSettings.packedVertices);
+    ImGui::Checkbox("Adaptive Mesh", &meshSettings.adaptive);
+    if (meshSettings.adaptive)
+      ImGui::SliderFloat("Max Error", &meshSettings.maxError, 0.0f, 1.0f);
+    ImGui::Checkbox("River Network", &showRiverNetwork);
     ImGui::End();
+
+    // Left of the Controls overlay
+    profilerPanel.Draw(ImVec2(screenWidth - 550, 10));
     rlImGuiEnd();
 
     EndDrawing();
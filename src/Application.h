@@ -2,6 +2,9 @@
 
 #include "Data/Project.h"
 #include "Data/World.h"
+#include "Render/TerrainMesh.h"
+#include "Render/TerrainRenderer.h"
+#include "UI/ProfilerPanel.h"
 #include "UI/Wizard.h"
 #include "imgui.h"
 #include "raylib.h"
@@ -22,6 +25,7 @@ private:
 
   Camera3D camera = {0};
   UI::Wizard wizard;
+  UI::ProfilerPanel profilerPanel;
 
   // Systems
   std::shared_ptr<Data::World> world;
@@ -32,6 +36,13 @@ private:
   RenderMode currentRenderMode = RenderMode::Lit;
   Shader lightingShader;
   Shader unlitShader;
+  Shader packedLightingShader; // Decode TerrainMesh::PackedChunk vertices
+  Shader packedUnlitShader;
+  Shader displacedShader; // Used by all modes when GPU displacement is on
+  int displacedLightingLoc = -1;
+  Render::TerrainMesh terrainMesh;
+  Render::TerrainRenderer terrainRenderer;
+  bool showRiverNetwork = false; // Debug lines for World::riverNetwork
 
   // Camera Control State
   void UpdateCustomCamera();
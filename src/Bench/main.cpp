@@ -0,0 +1,329 @@
+// genesis_bench: times every generator stage over a range of grid sizes and
+// prints the results as JSON, so runs can be diffed between releases.
+//
+//   genesis_bench [--sizes 128,256,...] [--repeats N] [--stages a,b,...]
+//                 [--droplets N] [-o FILE] [--mesh]
+//
+// Stages: terrain, rivers, erosion, erosion_grid, thermal, tensor_generate,
+// tensor_sample, tensor_sample_batch and, in builds with the editor, mesh
+// (TerrainMesh::Update; needs --mesh since it opens a hidden window for the GL
+// context). Each stage reports the minimum and median of its repeats plus its
+// throughput: cells/sec for grid passes, droplets/sec for erosion, cell
+// steps/sec for grid and thermal erosion and samples/sec for tensor sampling.
+
+#include "../Core/Random.h"
+#include "../Core/ThreadPool.h"
+#include "../Data/World.h"
+#include "../Generator/ErosionGenerator.h"
+#include "../Generator/RiverGenerator.h"
+#include "../Generator/TensorField.h"
+#include "../Generator/TerrainGenerator.h"
+#include "../Generator/ThermalErosionGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef GENESIS_BENCH_MESH
+#include "../Render/TerrainMesh.h"
+#include "raylib.h"
+#endif
+
+namespace {
+
+using namespace Genesis;
+
+struct Options {
+  std::vector<int> sizes = {128, 256, 512, 1024, 2048, 4096};
+  std::vector<std::string> stages = {
+      "terrain",       "rivers",          "erosion",
+      "erosion_grid",  "thermal",         "tensor_generate",
+      "tensor_sample", "tensor_sample_batch"};
+  int repeats = 3;
+  int droplets = 50000;
+  int samples = 1 << 22;
+  std::string output;
+  bool mesh = false;
+};
+
+struct Result {
+  std::string stage;
+  int size = 0;
+  std::vector<double> times; // Seconds, one per repeat
+  double work = 0;           // Units processed per run
+  const char *unit = "cells";
+};
+
+// Times `run` once per repeat. `setup` runs before every repeat and is not
+// part of the measurement.
+Result Measure(const std::string &stage, int size, int repeats, double work,
+               const char *unit, const std::function<void()> &setup,
+               const std::function<void()> &run) {
+  Result result;
+  result.stage = stage;
+  result.size = size;
+  result.work = work;
+  result.unit = unit;
+  for (int i = 0; i < repeats; i++) {
+    if (setup)
+      setup();
+    auto start = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    result.times.push_back(elapsed.count());
+  }
+  return result;
+}
+
+const char *SimdLevel() {
+#if defined(__AVX2__)
+  return "avx2";
+#elif defined(__SSE4_1__)
+  return "sse4.1";
+#else
+  return "scalar";
+#endif
+}
+
+std::vector<std::string> Split(const std::string &list) {
+  std::vector<std::string> items;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ','))
+    if (!item.empty())
+      items.push_back(item);
+  return items;
+}
+
+bool HasStage(const Options &options, const char *stage) {
+  return std::find(options.stages.begin(), options.stages.end(), stage) !=
+         options.stages.end();
+}
+
+void WriteJson(FILE *out, const Options &options,
+               const std::vector<Result> &results) {
+  std::fprintf(out, "{\n");
+  std::fprintf(out, "  \"threads\": %d,\n",
+               Core::ThreadPool::Get().GetThreadCount());
+  std::fprintf(out, "  \"simd\": \"%s\",\n", SimdLevel());
+  std::fprintf(out, "  \"repeats\": %d,\n", options.repeats);
+  std::fprintf(out, "  \"results\": [");
+  for (size_t i = 0; i < results.size(); i++) {
+    const Result &r = results[i];
+    std::vector<double> sorted = r.times;
+    std::sort(sorted.begin(), sorted.end());
+    double best = sorted.front();
+    double median = sorted[sorted.size() / 2];
+
+    std::fprintf(out, "%s\n    {\"stage\": \"%s\", \"size\": %d, ",
+                 i == 0 ? "" : ",", r.stage.c_str(), r.size);
+    std::fprintf(out, "\"min_ms\": %.3f, \"median_ms\": %.3f, ", best * 1e3,
+                 median * 1e3);
+    std::fprintf(out, "\"%s\": %.0f, \"%s_per_sec\": %.0f}", r.unit, r.work,
+                 r.unit, r.work / best);
+  }
+  std::fprintf(out, "\n  ]\n}\n");
+}
+
+void PrintUsage() {
+  std::fprintf(stderr,
+               "usage: genesis_bench [--sizes 128,256,...] [--repeats N] "
+               "[--stages a,b,...] [--droplets N] [-o FILE] [--mesh]\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (std::strcmp(arg, "--sizes") == 0 && hasValue) {
+      options.sizes.clear();
+      for (const auto &size : Split(argv[++i]))
+        options.sizes.push_back(std::atoi(size.c_str()));
+    } else if (std::strcmp(arg, "--stages") == 0 && hasValue) {
+      options.stages = Split(argv[++i]);
+    } else if (std::strcmp(arg, "--repeats") == 0 && hasValue) {
+      options.repeats = std::max(1, std::atoi(argv[++i]));
+    } else if (std::strcmp(arg, "--droplets") == 0 && hasValue) {
+      options.droplets = std::max(1, std::atoi(argv[++i]));
+    } else if (std::strcmp(arg, "-o") == 0 && hasValue) {
+      options.output = argv[++i];
+    } else if (std::strcmp(arg, "--mesh") == 0) {
+      options.mesh = true;
+    } else {
+      PrintUsage();
+      return 2;
+    }
+  }
+
+#ifdef GENESIS_BENCH_MESH
+  if (options.mesh) {
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(64, 64, "genesis_bench");
+    options.stages.push_back("mesh");
+  }
+#else
+  if (options.mesh) {
+    std::fprintf(stderr, "genesis_bench: built without the mesh stage "
+                         "(GENESIS_BUILD_APP=OFF)\n");
+    return 2;
+  }
+#endif
+
+  std::vector<Result> results;
+  for (int size : options.sizes) {
+    if (size < 2)
+      continue;
+    double cells = (double)size * size;
+    std::fprintf(stderr, "size %d\n", size);
+
+    Data::World world;
+    Generator::TerrainGenerator::Config terrainConfig;
+    terrainConfig.width = size;
+    terrainConfig.depth = size;
+    terrainConfig.noiseScale = 4.0f;
+    auto generate = [&] {
+      Generator::TerrainGenerator::Generate(world, terrainConfig);
+    };
+
+    if (HasStage(options, "terrain"))
+      results.push_back(Measure("terrain", size, options.repeats, cells,
+                                "cells", nullptr, generate));
+
+    // Later stages work on a generated terrain. Rivers restore the base
+    // heightmap and erosion its pre-erosion snapshot, so repeats see the same
+    // input without regenerating.
+    generate();
+
+    if (HasStage(options, "rivers")) {
+      Generator::RiverGenerator::Config riverConfig;
+      results.push_back(Measure("rivers", size, options.repeats, cells,
+                                "cells", nullptr, [&] {
+                                  Generator::RiverGenerator::Generate(
+                                      world, riverConfig, terrainConfig);
+                                }));
+    }
+
+    if (HasStage(options, "erosion")) {
+      Generator::ErosionGenerator::Config erosionConfig;
+      erosionConfig.iterations = options.droplets;
+      results.push_back(Measure("erosion", size, options.repeats,
+                                options.droplets, "droplets", nullptr, [&] {
+                                  Generator::ErosionGenerator::Execute(
+                                      world, erosionConfig, terrainConfig);
+                                }));
+    }
+
+    if (HasStage(options, "erosion_grid")) {
+      Generator::ErosionGenerator::Config erosionConfig;
+      erosionConfig.method = Generator::ErosionGenerator::Method::Grid;
+      erosionConfig.gridSteps = 100;
+      results.push_back(Measure(
+          "erosion_grid", size, options.repeats,
+          cells * erosionConfig.gridSteps, "cell_steps", nullptr, [&] {
+            Generator::ErosionGenerator::Execute(world, erosionConfig,
+                                                 terrainConfig);
+          }));
+    }
+
+    if (HasStage(options, "thermal")) {
+      Generator::ThermalErosionGenerator::Config thermalConfig;
+      results.push_back(Measure(
+          "thermal", size, options.repeats, cells * thermalConfig.iterations,
+          "cell_steps", nullptr, [&] {
+            Generator::ThermalErosionGenerator::Execute(world, thermalConfig,
+                                                        terrainConfig);
+          }));
+    }
+
+    Generator::TensorField field(size, size);
+    if (HasStage(options, "tensor_generate"))
+      results.push_back(Measure("tensor_generate", size, options.repeats,
+                                cells, "cells", nullptr,
+                                [&] {
+                                  field.Generate(12345);
+                                  field.Evaluate();
+                                }));
+
+    if (HasStage(options, "tensor_sample") ||
+        HasStage(options, "tensor_sample_batch")) {
+      // Fixed pseudo-random positions, so every size samples the same count
+      // with cache behaviour that scales with the grid
+      std::vector<float> pointsX(options.samples);
+      std::vector<float> pointsZ(options.samples);
+      Core::Random random(1);
+      for (int i = 0; i < options.samples; i++) {
+        pointsX[i] = random.NextFloat() * size;
+        pointsZ[i] = random.NextFloat() * size;
+      }
+
+      field.Generate(12345);
+      float sink = 0.0f;
+      if (HasStage(options, "tensor_sample"))
+        results.push_back(Measure(
+            "tensor_sample", size, options.repeats, options.samples,
+            "samples", nullptr, [&] {
+              for (int i = 0; i < options.samples; i++) {
+                Core::Vec2 v = field.Sample(pointsX[i], pointsZ[i]);
+                sink += v.x + v.y;
+              }
+            }));
+      if (HasStage(options, "tensor_sample_batch")) {
+        std::vector<float> dirX(options.samples);
+        std::vector<float> dirZ(options.samples);
+        results.push_back(Measure(
+            "tensor_sample_batch", size, options.repeats, options.samples,
+            "samples", nullptr, [&] {
+              field.Sample(pointsX.data(), pointsZ.data(), options.samples,
+                           dirX.data(), dirZ.data());
+              sink += dirX[0] + dirZ.back();
+            }));
+      }
+      // Keeps the loop from being optimized away
+      if (sink == 12345.0f)
+        std::fprintf(stderr, " ");
+    }
+
+#ifdef GENESIS_BENCH_MESH
+    if (HasStage(options, "mesh")) {
+      // Full rebuild (allocation, vertex pass, upload) of a fresh mesh
+      Render::TerrainMesh mesh;
+      results.push_back(Measure(
+          "mesh", size, options.repeats, cells, "cells",
+          [&] {
+            mesh.Unload();
+            world.terrain->MarkAllDirty();
+          },
+          [&] { mesh.Update(*world.terrain); }));
+    }
+#endif
+  }
+
+#ifdef GENESIS_BENCH_MESH
+  if (options.mesh)
+    CloseWindow();
+#endif
+
+  FILE *out = stdout;
+  if (!options.output.empty()) {
+    out = std::fopen(options.output.c_str(), "w");
+    if (!out) {
+      std::fprintf(stderr, "genesis_bench: can't write '%s'\n",
+                   options.output.c_str());
+      return 1;
+    }
+  }
+  WriteJson(out, options, results);
+  if (out != stdout)
+    std::fclose(out);
+  return 0;
+}
@@ -0,0 +1,24 @@
+#include "Job.h"
+#include <utility>
+
+namespace Genesis::Core {
+
+Job::Job(std::string name, std::function<void(JobProgress &)> fn)
+    : name(std::move(name)) {
+  // Started last, so every member is ready before the thread touches it
+  thread = std::thread([this, fn = std::move(fn)] {
+    fn(progress);
+    progress.Set(1.0f);
+    // Release pairs with IsDone's acquire: the job's writes are visible to
+    // whoever sees done == true
+    done.store(true, std::memory_order_release);
+  });
+}
+
+Job::~Job() {
+  Cancel();
+  if (thread.joinable())
+    thread.join();
+}
+
+} // namespace Genesis::Core
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace Genesis::Core {
+
+// Shared between a running job and whoever watches it. Generators take an
+// optional pointer to one: they report progress through it and poll it to
+// stop early when cancelled.
+class JobProgress {
+public:
+  // Fraction of the work done, [0, 1]
+  void Set(float fraction) {
+    this->fraction.store(fraction, std::memory_order_relaxed);
+  }
+  float Get() const { return fraction.load(std::memory_order_relaxed); }
+
+  void Cancel() { cancelled.store(true, std::memory_order_relaxed); }
+  bool IsCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<float> fraction{0.0f};
+  std::atomic<bool> cancelled{false};
+};
+
+// Runs one function on its own thread, so long generator runs don't block
+// the caller. The function may still use ThreadPool::ParallelFor. Poll
+// IsDone() and read the results only after it returns true.
+class Job {
+public:
+  Job(std::string name, std::function<void(JobProgress &)> fn);
+  // Cancels and waits for the thread
+  ~Job();
+
+  Job(const Job &) = delete;
+  Job &operator=(const Job &) = delete;
+
+  const std::string &GetName() const { return name; }
+  float GetProgress() const { return progress.Get(); }
+
+  void Cancel() { progress.Cancel(); }
+  bool IsCancelled() const { return progress.IsCancelled(); }
+
+  // True once the function has returned (finished or stopped early)
+  bool IsDone() const { return done.load(std::memory_order_acquire); }
+
+private:
+  std::string name;
+  JobProgress progress;
+  std::atomic<bool> done{false};
+  std::thread thread;
+};
+
+} // namespace Genesis::Core
@@ -0,0 +1,16 @@
+#pragma once
+
+namespace Genesis::Core {
+
+// Minimal vector types for the generators. They mirror raylib's layout
+// (Render converts with a plain aggregate copy) but keep the core library free
+// of any window/GL dependency.
+
+constexpr float Pi = 3.14159265358979323846f;
+
+struct Vec2 {
+  float x = 0.0f;
+  float y = 0.0f;
+};
+
+} // namespace Genesis::Core
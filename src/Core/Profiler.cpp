@@ -0,0 +1,117 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+namespace Genesis::Core {
+
+namespace {
+
+const std::chrono::steady_clock::time_point Epoch =
+    std::chrono::steady_clock::now();
+
+// Small stable ids read better in trace viewers than hashed thread ids
+int GetThreadIndex() {
+  static std::atomic<int> nextIndex{0};
+  thread_local int index = nextIndex.fetch_add(1);
+  return index;
+}
+
+void WriteJsonString(std::ofstream &out, const char *text) {
+  out << '"';
+  for (const char *c = text; *c; c++) {
+    if (*c == '"' || *c == '\\')
+      out << '\\';
+    out << *c;
+  }
+  out << '"';
+}
+
+} // namespace
+
+Profiler &Profiler::Get() {
+  static Profiler profiler;
+  return profiler;
+}
+
+int64_t Profiler::Now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - Epoch)
+      .count();
+}
+
+void Profiler::Record(const char *name, int64_t startNs, int64_t endNs) {
+  int thread = GetThreadIndex();
+  double ms = (endNs - startNs) * 1e-6;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (events.size() < MaxEvents)
+    events.push_back({name, startNs, endNs - startNs, thread});
+  else
+    dropped++;
+
+  Stat *stat = nullptr;
+  for (auto &s : stats) {
+    if (s.name == name) {
+      stat = &s;
+      break;
+    }
+  }
+  if (!stat) {
+    stats.push_back({});
+    stat = &stats.back();
+    stat->name = name;
+  }
+  stat->calls++;
+  stat->lastMs = ms;
+  stat->totalMs += ms;
+  stat->maxMs = std::max(stat->maxMs, ms);
+}
+
+std::vector<Profiler::Stat> Profiler::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return stats;
+}
+
+int Profiler::GetEventCount() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return (int)events.size();
+}
+
+int Profiler::GetDroppedCount() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return dropped;
+}
+
+void Profiler::Reset() {
+  std::lock_guard<std::mutex> lock(mutex);
+  events.clear();
+  stats.clear();
+  dropped = 0;
+}
+
+bool Profiler::WriteChromeTrace(const std::string &path) const {
+  std::ofstream out(path);
+  if (!out.is_open())
+    return false;
+
+  // Fixed notation keeps sub-microsecond resolution on long sessions
+  out << std::fixed << std::setprecision(3);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  // Complete ("X") events; timestamps and durations are in microseconds
+  out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  for (size_t i = 0; i < events.size(); i++) {
+    const Event &event = events[i];
+    out << (i == 0 ? "\n" : ",\n") << "{\"name\": ";
+    WriteJsonString(out, event.name);
+    out << ", \"cat\": \"genesis\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+        << event.thread << ", \"ts\": " << event.start / 1000.0
+        << ", \"dur\": " << event.duration / 1000.0 << "}";
+  }
+  out << "\n]}\n";
+  return out.good();
+}
+
+} // namespace Genesis::Core
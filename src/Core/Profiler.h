@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Genesis::Core {
+
+// Process-wide collector for scoped stage timings. Disabled by default; a
+// disabled scope costs one relaxed atomic load, so the scopes stay compiled
+// into release builds. When enabled, every scope is kept as an event (for the
+// Chrome trace) and folded into per-name stats (for the UI panel).
+//
+// Scopes are meant for stages and loops, not per-cell work: recording takes
+// a lock.
+class Profiler {
+public:
+  struct Stat {
+    std::string name;
+    int calls = 0;
+    double lastMs = 0.0;
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+  };
+
+  static Profiler &Get();
+
+  static bool IsEnabled() { return enabled.load(std::memory_order_relaxed); }
+  static void SetEnabled(bool on) {
+    enabled.store(on, std::memory_order_relaxed);
+  }
+
+  // Nanoseconds on a steady clock, relative to process start
+  static int64_t Now();
+
+  // Adds one finished scope. `name` must outlive the profiler (a literal).
+  void Record(const char *name, int64_t startNs, int64_t endNs);
+
+  // Per-name stats, in first-seen order
+  std::vector<Stat> GetStats() const;
+  int GetEventCount() const;
+  int GetDroppedCount() const;
+
+  // Drops all events and stats
+  void Reset();
+
+  // Writes the recorded events in the Trace Event format understood by
+  // chrome://tracing and Perfetto. Returns false if the file can't be written.
+  bool WriteChromeTrace(const std::string &path) const;
+
+private:
+  struct Event {
+    const char *name;
+    int64_t start;
+    int64_t duration;
+    int thread;
+  };
+
+  // Keeps a long session from growing without bound; later events are
+  // counted but not stored (stats still update)
+  static constexpr size_t MaxEvents = 1 << 20;
+
+  inline static std::atomic<bool> enabled{false};
+
+  mutable std::mutex mutex;
+  std::vector<Event> events;
+  std::vector<Stat> stats;
+  int dropped = 0;
+};
+
+// RAII timer behind GENESIS_PROFILE_SCOPE
+class ProfileScope {
+public:
+  explicit ProfileScope(const char *name)
+      : name(name), start(Profiler::IsEnabled() ? Profiler::Now() : -1) {}
+  ~ProfileScope() {
+    if (start >= 0)
+      Profiler::Get().Record(name, start, Profiler::Now());
+  }
+
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+  const char *name;
+  int64_t start;
+};
+
+} // namespace Genesis::Core
+
+#define GENESIS_PROFILE_CONCAT_INNER(a, b) a##b
+#define GENESIS_PROFILE_CONCAT(a, b) GENESIS_PROFILE_CONCAT_INNER(a, b)
+
+// Times the rest of the enclosing scope under `name` (a string literal,
+// "Stage/Step" by convention)
+#define GENESIS_PROFILE_SCOPE(name)                                            \
+  ::Genesis::Core::ProfileScope GENESIS_PROFILE_CONCAT(genesisProfileScope,    \
+                                                       __LINE__)(name)
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Genesis::Core {
+
+// Small seeded PRNG (SplitMix64). Replaces raylib's global GetRandomValue in
+// the generators: every run with the same seed produces the same map, on any
+// platform and without a window.
+class Random {
+public:
+  explicit Random(uint64_t seed) : state(seed) {}
+
+  uint64_t Next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+  }
+
+  // Uniform integer in [min, max], like GetRandomValue
+  int NextInt(int min, int max) {
+    if (max <= min)
+      return min;
+    uint64_t range = (uint64_t)((int64_t)max - min) + 1;
+    return (int)(min + (int64_t)(Next() % range));
+  }
+
+  // Uniform float in [0, 1)
+  float NextFloat() { return (float)(Next() >> 40) * (1.0f / 16777216.0f); }
+
+private:
+  uint64_t state;
+};
+
+} // namespace Genesis::Core
@@ -0,0 +1,356 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+namespace Genesis::Core::Simd {
+
+// Thin wrappers over the widest float/int registers the build targets.
+// Kernels are written as templates over the lane count W so that the scalar
+// instantiation (W = 1) handles row tails with exactly the same math.
+//
+// Masks are represented as Float<W> with all bits set in active lanes (the
+// same convention SSE/AVX compares use), so Select() works on every width.
+
+template <int W> struct Float;
+template <int W> struct Int;
+
+// --- Scalar (W = 1) ---
+
+template <> struct Float<1> {
+  float v;
+
+  Float() = default;
+  Float(float s) : v(s) {}
+
+  static Float Load(const float *p) { return Float(*p); }
+  void Store(float *p) const { *p = v; }
+
+  float Lane(int) const { return v; }
+};
+
+template <> struct Int<1> {
+  int32_t v;
+
+  Int() = default;
+  Int(int32_t s) : v(s) {}
+
+  static Int Load(const int32_t *p) { return Int(*p); }
+  void Store(int32_t *p) const { *p = v; }
+
+  int32_t Lane(int) const { return v; }
+};
+
+inline Float<1> operator+(Float<1> a, Float<1> b) { return a.v + b.v; }
+inline Float<1> operator-(Float<1> a, Float<1> b) { return a.v - b.v; }
+inline Float<1> operator*(Float<1> a, Float<1> b) { return a.v * b.v; }
+inline Float<1> operator/(Float<1> a, Float<1> b) { return a.v / b.v; }
+inline Float<1> Min(Float<1> a, Float<1> b) { return a.v < b.v ? a.v : b.v; }
+inline Float<1> Max(Float<1> a, Float<1> b) { return a.v > b.v ? a.v : b.v; }
+inline Float<1> Floor(Float<1> a) { return std::floor(a.v); }
+inline Float<1> Sqrt(Float<1> a) { return std::sqrt(a.v); }
+
+inline Float<1> MaskFromBool(bool b) {
+  return std::bit_cast<float>(b ? 0xFFFFFFFFu : 0u);
+}
+inline Float<1> operator<(Float<1> a, Float<1> b) {
+  return MaskFromBool(a.v < b.v);
+}
+inline Float<1> operator>(Float<1> a, Float<1> b) {
+  return MaskFromBool(a.v > b.v);
+}
+inline Float<1> operator<=(Float<1> a, Float<1> b) {
+  return MaskFromBool(a.v <= b.v);
+}
+inline Float<1> operator>=(Float<1> a, Float<1> b) {
+  return MaskFromBool(a.v >= b.v);
+}
+inline Float<1> And(Float<1> a, Float<1> b) {
+  return std::bit_cast<float>(std::bit_cast<uint32_t>(a.v) &
+                              std::bit_cast<uint32_t>(b.v));
+}
+inline Float<1> AndNot(Float<1> mask, Float<1> b) {
+  return std::bit_cast<float>(~std::bit_cast<uint32_t>(mask.v) &
+                              std::bit_cast<uint32_t>(b.v));
+}
+inline Float<1> Or(Float<1> a, Float<1> b) {
+  return std::bit_cast<float>(std::bit_cast<uint32_t>(a.v) |
+                              std::bit_cast<uint32_t>(b.v));
+}
+// Returns a where mask is set, b otherwise
+inline Float<1> Select(Float<1> mask, Float<1> a, Float<1> b) {
+  return std::bit_cast<uint32_t>(mask.v) ? a : b;
+}
+inline bool Any(Float<1> mask) { return std::bit_cast<uint32_t>(mask.v) != 0; }
+
+inline Int<1> operator+(Int<1> a, Int<1> b) {
+  return (int32_t)((uint32_t)a.v + (uint32_t)b.v);
+}
+inline Int<1> operator-(Int<1> a, Int<1> b) {
+  return (int32_t)((uint32_t)a.v - (uint32_t)b.v);
+}
+inline Int<1> operator*(Int<1> a, Int<1> b) {
+  return (int32_t)((uint32_t)a.v * (uint32_t)b.v);
+}
+inline Int<1> operator^(Int<1> a, Int<1> b) { return a.v ^ b.v; }
+inline Int<1> operator&(Int<1> a, Int<1> b) { return a.v & b.v; }
+inline Int<1> operator|(Int<1> a, Int<1> b) { return a.v | b.v; }
+inline Int<1> operator<<(Int<1> a, int n) {
+  return (int32_t)((uint32_t)a.v << n);
+}
+// Logical (zero-filling) shift, which is what hashing wants
+inline Int<1> operator>>(Int<1> a, int n) {
+  return (int32_t)((uint32_t)a.v >> n);
+}
+inline Float<1> operator==(Int<1> a, Int<1> b) {
+  return MaskFromBool(a.v == b.v);
+}
+
+// Truncating conversion (callers Floor() first when they need floor)
+inline Int<1> ToInt(Float<1> a) { return (int32_t)a.v; }
+inline Float<1> ToFloat(Int<1> a) { return (float)a.v; }
+inline Int<1> AsInt(Float<1> a) { return std::bit_cast<int32_t>(a.v); }
+inline Float<1> AsFloat(Int<1> a) { return std::bit_cast<float>(a.v); }
+
+inline Float<1> Gather(const float *base, Int<1> index) {
+  return base[index.v];
+}
+
+#if defined(__AVX2__)
+
+// --- AVX2 (W = 8) ---
+
+template <> struct Float<8> {
+  __m256 v;
+
+  Float() = default;
+  Float(__m256 r) : v(r) {}
+  Float(float s) : v(_mm256_set1_ps(s)) {}
+
+  static Float Load(const float *p) { return _mm256_loadu_ps(p); }
+  void Store(float *p) const { _mm256_storeu_ps(p, v); }
+
+  float Lane(int i) const {
+    alignas(32) float tmp[8];
+    _mm256_store_ps(tmp, v);
+    return tmp[i];
+  }
+};
+
+template <> struct Int<8> {
+  __m256i v;
+
+  Int() = default;
+  Int(__m256i r) : v(r) {}
+  Int(int32_t s) : v(_mm256_set1_epi32(s)) {}
+
+  static Int Load(const int32_t *p) {
+    return _mm256_loadu_si256((const __m256i *)p);
+  }
+  void Store(int32_t *p) const { _mm256_storeu_si256((__m256i *)p, v); }
+
+  int32_t Lane(int i) const {
+    alignas(32) int32_t tmp[8];
+    _mm256_store_si256((__m256i *)tmp, v);
+    return tmp[i];
+  }
+};
+
+inline Float<8> operator+(Float<8> a, Float<8> b) {
+  return _mm256_add_ps(a.v, b.v);
+}
+inline Float<8> operator-(Float<8> a, Float<8> b) {
+  return _mm256_sub_ps(a.v, b.v);
+}
+inline Float<8> operator*(Float<8> a, Float<8> b) {
+  return _mm256_mul_ps(a.v, b.v);
+}
+inline Float<8> operator/(Float<8> a, Float<8> b) {
+  return _mm256_div_ps(a.v, b.v);
+}
+inline Float<8> Min(Float<8> a, Float<8> b) { return _mm256_min_ps(a.v, b.v); }
+inline Float<8> Max(Float<8> a, Float<8> b) { return _mm256_max_ps(a.v, b.v); }
+inline Float<8> Floor(Float<8> a) { return _mm256_floor_ps(a.v); }
+inline Float<8> Sqrt(Float<8> a) { return _mm256_sqrt_ps(a.v); }
+
+inline Float<8> operator<(Float<8> a, Float<8> b) {
+  return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ);
+}
+inline Float<8> operator>(Float<8> a, Float<8> b) {
+  return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ);
+}
+inline Float<8> operator<=(Float<8> a, Float<8> b) {
+  return _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ);
+}
+inline Float<8> operator>=(Float<8> a, Float<8> b) {
+  return _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ);
+}
+inline Float<8> And(Float<8> a, Float<8> b) { return _mm256_and_ps(a.v, b.v); }
+inline Float<8> AndNot(Float<8> mask, Float<8> b) {
+  return _mm256_andnot_ps(mask.v, b.v);
+}
+inline Float<8> Or(Float<8> a, Float<8> b) { return _mm256_or_ps(a.v, b.v); }
+inline Float<8> Select(Float<8> mask, Float<8> a, Float<8> b) {
+  return _mm256_blendv_ps(b.v, a.v, mask.v);
+}
+inline bool Any(Float<8> mask) { return _mm256_movemask_ps(mask.v) != 0; }
+
+inline Int<8> operator+(Int<8> a, Int<8> b) {
+  return _mm256_add_epi32(a.v, b.v);
+}
+inline Int<8> operator-(Int<8> a, Int<8> b) {
+  return _mm256_sub_epi32(a.v, b.v);
+}
+inline Int<8> operator*(Int<8> a, Int<8> b) {
+  return _mm256_mullo_epi32(a.v, b.v);
+}
+inline Int<8> operator^(Int<8> a, Int<8> b) {
+  return _mm256_xor_si256(a.v, b.v);
+}
+inline Int<8> operator&(Int<8> a, Int<8> b) {
+  return _mm256_and_si256(a.v, b.v);
+}
+inline Int<8> operator|(Int<8> a, Int<8> b) {
+  return _mm256_or_si256(a.v, b.v);
+}
+inline Int<8> operator<<(Int<8> a, int n) { return _mm256_slli_epi32(a.v, n); }
+inline Int<8> operator>>(Int<8> a, int n) { return _mm256_srli_epi32(a.v, n); }
+inline Float<8> operator==(Int<8> a, Int<8> b) {
+  return _mm256_castsi256_ps(_mm256_cmpeq_epi32(a.v, b.v));
+}
+
+inline Int<8> ToInt(Float<8> a) { return _mm256_cvttps_epi32(a.v); }
+inline Float<8> ToFloat(Int<8> a) { return _mm256_cvtepi32_ps(a.v); }
+inline Int<8> AsInt(Float<8> a) { return _mm256_castps_si256(a.v); }
+inline Float<8> AsFloat(Int<8> a) { return _mm256_castsi256_ps(a.v); }
+
+inline Float<8> Gather(const float *base, Int<8> index) {
+  return _mm256_i32gather_ps(base, index.v, 4);
+}
+
+constexpr int NativeWidth = 8;
+
+#elif defined(__SSE4_1__)
+
+// --- SSE4.1 (W = 4) ---
+
+template <> struct Float<4> {
+  __m128 v;
+
+  Float() = default;
+  Float(__m128 r) : v(r) {}
+  Float(float s) : v(_mm_set1_ps(s)) {}
+
+  static Float Load(const float *p) { return _mm_loadu_ps(p); }
+  void Store(float *p) const { _mm_storeu_ps(p, v); }
+
+  float Lane(int i) const {
+    alignas(16) float tmp[4];
+    _mm_store_ps(tmp, v);
+    return tmp[i];
+  }
+};
+
+template <> struct Int<4> {
+  __m128i v;
+
+  Int() = default;
+  Int(__m128i r) : v(r) {}
+  Int(int32_t s) : v(_mm_set1_epi32(s)) {}
+
+  static Int Load(const int32_t *p) {
+    return _mm_loadu_si128((const __m128i *)p);
+  }
+  void Store(int32_t *p) const { _mm_storeu_si128((__m128i *)p, v); }
+
+  int32_t Lane(int i) const {
+    alignas(16) int32_t tmp[4];
+    _mm_store_si128((__m128i *)tmp, v);
+    return tmp[i];
+  }
+};
+
+inline Float<4> operator+(Float<4> a, Float<4> b) {
+  return _mm_add_ps(a.v, b.v);
+}
+inline Float<4> operator-(Float<4> a, Float<4> b) {
+  return _mm_sub_ps(a.v, b.v);
+}
+inline Float<4> operator*(Float<4> a, Float<4> b) {
+  return _mm_mul_ps(a.v, b.v);
+}
+inline Float<4> operator/(Float<4> a, Float<4> b) {
+  return _mm_div_ps(a.v, b.v);
+}
+inline Float<4> Min(Float<4> a, Float<4> b) { return _mm_min_ps(a.v, b.v); }
+inline Float<4> Max(Float<4> a, Float<4> b) { return _mm_max_ps(a.v, b.v); }
+inline Float<4> Floor(Float<4> a) { return _mm_floor_ps(a.v); }
+inline Float<4> Sqrt(Float<4> a) { return _mm_sqrt_ps(a.v); }
+
+inline Float<4> operator<(Float<4> a, Float<4> b) {
+  return _mm_cmplt_ps(a.v, b.v);
+}
+inline Float<4> operator>(Float<4> a, Float<4> b) {
+  return _mm_cmpgt_ps(a.v, b.v);
+}
+inline Float<4> operator<=(Float<4> a, Float<4> b) {
+  return _mm_cmple_ps(a.v, b.v);
+}
+inline Float<4> operator>=(Float<4> a, Float<4> b) {
+  return _mm_cmpge_ps(a.v, b.v);
+}
+inline Float<4> And(Float<4> a, Float<4> b) { return _mm_and_ps(a.v, b.v); }
+inline Float<4> AndNot(Float<4> mask, Float<4> b) {
+  return _mm_andnot_ps(mask.v, b.v);
+}
+inline Float<4> Or(Float<4> a, Float<4> b) { return _mm_or_ps(a.v, b.v); }
+inline Float<4> Select(Float<4> mask, Float<4> a, Float<4> b) {
+  return _mm_blendv_ps(b.v, a.v, mask.v);
+}
+inline bool Any(Float<4> mask) { return _mm_movemask_ps(mask.v) != 0; }
+
+inline Int<4> operator+(Int<4> a, Int<4> b) { return _mm_add_epi32(a.v, b.v); }
+inline Int<4> operator-(Int<4> a, Int<4> b) { return _mm_sub_epi32(a.v, b.v); }
+inline Int<4> operator*(Int<4> a, Int<4> b) {
+  return _mm_mullo_epi32(a.v, b.v);
+}
+inline Int<4> operator^(Int<4> a, Int<4> b) { return _mm_xor_si128(a.v, b.v); }
+inline Int<4> operator&(Int<4> a, Int<4> b) { return _mm_and_si128(a.v, b.v); }
+inline Int<4> operator|(Int<4> a, Int<4> b) { return _mm_or_si128(a.v, b.v); }
+inline Int<4> operator<<(Int<4> a, int n) { return _mm_slli_epi32(a.v, n); }
+inline Int<4> operator>>(Int<4> a, int n) { return _mm_srli_epi32(a.v, n); }
+inline Float<4> operator==(Int<4> a, Int<4> b) {
+  return _mm_castsi128_ps(_mm_cmpeq_epi32(a.v, b.v));
+}
+
+inline Int<4> ToInt(Float<4> a) { return _mm_cvttps_epi32(a.v); }
+inline Float<4> ToFloat(Int<4> a) { return _mm_cvtepi32_ps(a.v); }
+inline Int<4> AsInt(Float<4> a) { return _mm_castps_si128(a.v); }
+inline Float<4> AsFloat(Int<4> a) { return _mm_castsi128_ps(a.v); }
+
+// No hardware gather before AVX2
+inline Float<4> Gather(const float *base, Int<4> index) {
+  alignas(16) int32_t idx[4];
+  index.Store(idx);
+  return _mm_setr_ps(base[idx[0]], base[idx[1]], base[idx[2]], base[idx[3]]);
+}
+
+constexpr int NativeWidth = 4;
+
+#else
+
+constexpr int NativeWidth = 1;
+
+#endif
+
+using FloatN = Float<NativeWidth>;
+using IntN = Int<NativeWidth>;
+
+} // namespace Genesis::Core::Simd
@@ -0,0 +1,103 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+
+namespace Genesis::Core {
+
+struct ThreadPool::Batch {
+  const std::function<void(int)> *fn = nullptr;
+  int count = 0;
+  std::atomic<int> next{0};
+  std::atomic<int> done{0};
+
+  std::mutex doneMutex;
+  std::condition_variable doneCondition;
+};
+
+ThreadPool &ThreadPool::Get() {
+  static ThreadPool pool(
+      std::max(1, (int)std::thread::hardware_concurrency() - 1));
+  return pool;
+}
+
+ThreadPool::ThreadPool(int workerCount) {
+  for (int i = 0; i < workerCount; i++)
+    workers.emplace_back([this] { WorkerLoop(); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    stopping = true;
+  }
+  queueCondition.notify_all();
+  for (auto &worker : workers)
+    worker.join();
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int)> &fn) {
+  if (count <= 0)
+    return;
+
+  if (count == 1 || workers.empty()) {
+    for (int i = 0; i < count; i++)
+      fn(i);
+    return;
+  }
+
+  auto batch = std::make_shared<Batch>();
+  batch->fn = &fn;
+  batch->count = count;
+
+  // One ticket per helper. Tickets picked up after the batch is finished find
+  // no indices left and return without touching fn.
+  int helpers = std::min((int)workers.size(), count - 1);
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    for (int i = 0; i < helpers; i++)
+      queue.push_back(batch);
+  }
+  if (helpers == 1)
+    queueCondition.notify_one();
+  else
+    queueCondition.notify_all();
+
+  RunBatch(*batch);
+
+  std::unique_lock<std::mutex> lock(batch->doneMutex);
+  batch->doneCondition.wait(lock,
+                            [&] { return batch->done.load() == count; });
+}
+
+void ThreadPool::RunBatch(Batch &batch) {
+  int ran = 0;
+  while (true) {
+    int i = batch.next.fetch_add(1);
+    if (i >= batch.count)
+      break;
+    (*batch.fn)(i);
+    ran++;
+  }
+
+  if (ran > 0 && batch.done.fetch_add(ran) + ran == batch.count) {
+    std::lock_guard<std::mutex> lock(batch.doneMutex);
+    batch.doneCondition.notify_all();
+  }
+}
+
+void ThreadPool::WorkerLoop() {
+  while (true) {
+    std::shared_ptr<Batch> batch;
+    {
+      std::unique_lock<std::mutex> lock(queueMutex);
+      queueCondition.wait(lock, [this] { return stopping || !queue.empty(); });
+      if (stopping)
+        return;
+      batch = std::move(queue.front());
+      queue.pop_front();
+    }
+    RunBatch(*batch);
+  }
+}
+
+} // namespace Genesis::Core
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Genesis::Core {
+
+// Process-wide pool of worker threads for data-parallel loops (tiles, rows).
+// The calling thread always helps with its own loop, so ParallelFor can be
+// used from any thread, including from inside another ParallelFor.
+class ThreadPool {
+public:
+  // Shared pool sized to the machine (hardware threads - 1 workers)
+  static ThreadPool &Get();
+
+  explicit ThreadPool(int workerCount);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  // Threads that execute work in a ParallelFor, including the caller
+  int GetThreadCount() const { return (int)workers.size() + 1; }
+
+  // Runs fn(i) for every i in [0, count) and blocks until all are done.
+  // Indices are handed out dynamically, so results must not depend on which
+  // thread runs which index.
+  void ParallelFor(int count, const std::function<void(int)> &fn);
+
+private:
+  struct Batch;
+
+  void WorkerLoop();
+  static void RunBatch(Batch &batch);
+
+  std::vector<std::thread> workers;
+
+  std::mutex queueMutex;
+  std::condition_variable queueCondition;
+  std::deque<std::shared_ptr<Batch>> queue;
+  bool stopping = false;
+};
+
+} // namespace Genesis::Core
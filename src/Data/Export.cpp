@@ -0,0 +1,60 @@
+#include "Export.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <vector>
+
+namespace Genesis::Data {
+
+bool WriteHeightMapPgm(const Terrain &terrain, const std::string &path) {
+  std::ofstream out(path, std::ios::binary);
+  if (!out.is_open())
+    return false;
+
+  out << "P5\n" << terrain.width << " " << terrain.depth << "\n65535\n";
+
+  // PGM stores 16-bit samples most significant byte first
+  std::vector<unsigned char> row(terrain.width * 2);
+  for (int z = 0; z < terrain.depth; z++) {
+    for (int x = 0; x < terrain.width; x++) {
+      float h = terrain.heightMap[z * terrain.width + x];
+      h = std::clamp(h, 0.0f, 1.0f);
+      auto value = (unsigned short)std::lround(h * 65535.0f);
+      row[x * 2] = (unsigned char)(value >> 8);
+      row[x * 2 + 1] = (unsigned char)(value & 0xFF);
+    }
+    out.write((const char *)row.data(), row.size());
+  }
+  return out.good();
+}
+
+bool WriteHeightMapRaw(const Terrain &terrain, const std::string &path) {
+  std::ofstream out(path, std::ios::binary);
+  if (!out.is_open())
+    return false;
+
+  // Written as-is, so this assumes a little-endian host (x86/ARM)
+  out.write((const char *)terrain.heightMap.data(),
+            terrain.heightMap.size() * sizeof(float));
+  return out.good();
+}
+
+bool WriteRiverMapPgm(const Terrain &terrain, const std::string &path) {
+  std::ofstream out(path, std::ios::binary);
+  if (!out.is_open())
+    return false;
+
+  out << "P5\n" << terrain.width << " " << terrain.depth << "\n255\n";
+
+  std::vector<unsigned char> empty;
+  bool hasRivers = terrain.riverMap.Matches(terrain.width, terrain.depth);
+  if (!hasRivers)
+    empty.assign(terrain.width, 0);
+  for (int z = 0; z < terrain.depth; z++) {
+    const uint8_t *row = hasRivers ? terrain.riverMap.Row(z) : empty.data();
+    out.write((const char *)row, terrain.width);
+  }
+  return out.good();
+}
+
+} // namespace Genesis::Data
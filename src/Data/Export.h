@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Terrain.h"
+#include <string>
+
+namespace Genesis::Data {
+
+// Plain-file exports of the terrain layers, readable by most image and GIS
+// tools. Each returns false if the file can't be written.
+
+// 16-bit binary PGM (P5), heights [0, 1] mapped to [0, 65535]
+bool WriteHeightMapPgm(const Terrain &terrain, const std::string &path);
+
+// Headerless little-endian float32, row-major (width x depth)
+bool WriteHeightMapRaw(const Terrain &terrain, const std::string &path);
+
+// 8-bit binary PGM of the river map (0 = none, >0 = river type)
+bool WriteRiverMapPgm(const Terrain &terrain, const std::string &path);
+
+} // namespace Genesis::Data
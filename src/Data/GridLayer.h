@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Genesis::Data {
+
+// Per-cell attribute grid (width * depth, row-major) with its own element
+// type, so small enums and labels don't pay for a full int per cell. Layers
+// on a Terrain share its dimensions: an empty layer means "not generated".
+template <typename T> class GridLayer {
+public:
+  using Value = T;
+
+  void Assign(int gridWidth, int gridDepth, T value = T()) {
+    width = gridWidth;
+    depth = gridDepth;
+    cells.assign((size_t)width * depth, value);
+  }
+  void Clear() {
+    cells.clear();
+    width = 0;
+    depth = 0;
+  }
+  void Fill(T value) { std::fill(cells.begin(), cells.end(), value); }
+
+  bool IsEmpty() const { return cells.empty(); }
+  bool Matches(int gridWidth, int gridDepth) const {
+    return !IsEmpty() && width == gridWidth && depth == gridDepth;
+  }
+  int GetWidth() const { return width; }
+  int GetDepth() const { return depth; }
+  size_t GetMemoryBytes() const { return cells.size() * sizeof(T); }
+
+  // Out of range (or on an empty layer) reads as T()
+  T Get(int x, int z) const {
+    if (x < 0 || x >= width || z < 0 || z >= depth)
+      return T();
+    return cells[(size_t)z * width + x];
+  }
+  void Set(int x, int z, T value) {
+    if (x < 0 || x >= width || z < 0 || z >= depth)
+      return;
+    cells[(size_t)z * width + x] = value;
+  }
+
+  // Unchecked cell index access (z * width + x)
+  T &operator[](size_t i) { return cells[i]; }
+  const T &operator[](size_t i) const { return cells[i]; }
+
+  // Bulk access: rows are contiguous, and so is the whole grid
+  T *Row(int z) { return cells.data() + (size_t)z * width; }
+  const T *Row(int z) const { return cells.data() + (size_t)z * width; }
+  T *Data() { return cells.data(); }
+  const T *Data() const { return cells.data(); }
+  size_t Size() const { return cells.size(); }
+
+private:
+  int width = 0;
+  int depth = 0;
+  std::vector<T> cells;
+};
+
+// One bit per cell for masks. Rows start on a word boundary, so a row is a
+// run of whole 64-bit words that can be scanned or combined a word at a time.
+class BitLayer {
+public:
+  using Word = uint64_t;
+  static constexpr int WordBits = 64;
+
+  void Assign(int gridWidth, int gridDepth, bool value = false) {
+    width = gridWidth;
+    depth = gridDepth;
+    wordsPerRow = (width + WordBits - 1) / WordBits;
+    words.assign((size_t)wordsPerRow * depth, value ? ~Word(0) : Word(0));
+    if (value)
+      ClearPadding();
+  }
+  void Clear() {
+    words.clear();
+    width = 0;
+    depth = 0;
+    wordsPerRow = 0;
+  }
+
+  bool IsEmpty() const { return words.empty(); }
+  bool Matches(int gridWidth, int gridDepth) const {
+    return !IsEmpty() && width == gridWidth && depth == gridDepth;
+  }
+  int GetWidth() const { return width; }
+  int GetDepth() const { return depth; }
+  int GetWordsPerRow() const { return wordsPerRow; }
+  size_t GetMemoryBytes() const { return words.size() * sizeof(Word); }
+
+  // Unchecked; see GridLayer::Get for the bounds-checked flavour
+  bool Test(int x, int z) const {
+    return (Row(z)[x / WordBits] >> (x % WordBits)) & 1;
+  }
+  void Set(int x, int z, bool value = true) {
+    Word bit = Word(1) << (x % WordBits);
+    Word &word = Row(z)[x / WordBits];
+    word = value ? (word | bit) : (word & ~bit);
+  }
+  bool Get(int x, int z) const {
+    if (x < 0 || x >= width || z < 0 || z >= depth)
+      return false;
+    return Test(x, z);
+  }
+
+  // Bits past the grid width in a row's last word are always zero
+  Word *Row(int z) { return words.data() + (size_t)z * wordsPerRow; }
+  const Word *Row(int z) const {
+    return words.data() + (size_t)z * wordsPerRow;
+  }
+
+private:
+  void ClearPadding() {
+    int tail = width % WordBits;
+    if (tail == 0)
+      return;
+    for (int z = 0; z < depth; z++)
+      Row(z)[wordsPerRow - 1] &= (Word(1) << tail) - 1;
+  }
+
+  int width = 0;
+  int depth = 0;
+  int wordsPerRow = 0;
+  std::vector<Word> words;
+};
+
+} // namespace Genesis::Data
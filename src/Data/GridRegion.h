@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+
+namespace Genesis::Data {
+
+// Inclusive rectangle of grid cells. Empty when x1 < x0.
+struct GridRegion {
+  int x0 = 0;
+  int z0 = 0;
+  int x1 = -1;
+  int z1 = -1;
+
+  static GridRegion Full(int width, int depth) {
+    return {0, 0, width - 1, depth - 1};
+  }
+
+  bool IsEmpty() const { return x1 < x0 || z1 < z0; }
+
+  void Include(int x, int z) {
+    if (IsEmpty()) {
+      x0 = x1 = x;
+      z0 = z1 = z;
+      return;
+    }
+    x0 = std::min(x0, x);
+    z0 = std::min(z0, z);
+    x1 = std::max(x1, x);
+    z1 = std::max(z1, z);
+  }
+
+  void Include(const GridRegion &other) {
+    if (other.IsEmpty())
+      return;
+    Include(other.x0, other.z0);
+    Include(other.x1, other.z1);
+  }
+
+  // Grows the region by n cells, clamped to the grid
+  void Expand(int n, int width, int depth) {
+    if (IsEmpty())
+      return;
+    x0 = std::max(x0 - n, 0);
+    z0 = std::max(z0 - n, 0);
+    x1 = std::min(x1 + n, width - 1);
+    z1 = std::min(z1 + n, depth - 1);
+  }
+};
+
+} // namespace Genesis::Data
@@ -72,19 +72,69 @@ std::string Project::ToJSON(const ConfigSnapshot &config) {
   ss << "    \"depth\": " << config.terrain.depth << ",\n";
   ss << "    \"seed\": " << config.terrain.seed << ",\n";
   ss << "    \"noiseScale\": " << config.terrain.noiseScale << ",\n";
+  ss << "    \"octaves\": " << config.terrain.octaves << ",\n";
+  ss << "    \"lacunarity\": " << config.terrain.lacunarity << ",\n";
+  ss << "    \"gain\": " << config.terrain.gain << ",\n";
   ss << "    \"heightMultiplier\": " << config.terrain.heightMultiplier
      << ",\n";
   ss << "    \"seaLevel\": " << config.terrain.seaLevel << "\n";
+  ss << "  },\n";
+  ss << "  \"rivers\": {\n";
+  ss << "    \"method\": " << (int)config.rivers.method << ",\n";
+  ss << "    \"minCatchment\": " << config.rivers.minCatchment << ",\n";
+  ss << "    \"minLakeCells\": " << config.rivers.minLakeCells << ",\n";
+  ss << "    \"widthScale\": " << config.rivers.widthScale << ",\n";
+  ss << "    \"riverCount\": " << config.rivers.riverCount << ",\n";
+  ss << "    \"minRiverLength\": " << config.rivers.minRiverLength << ",\n";
+  ss << "    \"minSourceHeight\": " << config.rivers.minSourceHeight << ",\n";
+  ss << "    \"seed\": " << config.rivers.seed << "\n";
+  ss << "  },\n";
+  ss << "  \"erosion\": {\n";
+  ss << "    \"method\": " << (int)config.erosion.method << ",\n";
+  ss << "    \"iterations\": " << config.erosion.iterations << ",\n";
+  ss << "    \"erosionRate\": " << config.erosion.erosionRate << ",\n";
+  ss << "    \"depositionRate\": " << config.erosion.depositionRate << ",\n";
+  ss << "    \"gravity\": " << config.erosion.gravity << ",\n";
+  ss << "    \"evaporationRate\": " << config.erosion.evaporationRate
+     << ",\n";
+  ss << "    \"erosionRadius\": " << config.erosion.erosionRadius << ",\n";
+  ss << "    \"maxLifetime\": " << config.erosion.maxLifetime << ",\n";
+  ss << "    \"inertia\": " << config.erosion.inertia << ",\n";
+  ss << "    \"startSpeed\": " << config.erosion.startSpeed << ",\n";
+  ss << "    \"startWater\": " << config.erosion.startWater << ",\n";
+  ss << "    \"minSlope\": " << config.erosion.minSlope << ",\n";
+  ss << "    \"capacityFactor\": " << config.erosion.capacityFactor << ",\n";
+  ss << "    \"seed\": " << config.erosion.seed << ",\n";
+  ss << "    \"gridSteps\": " << config.erosion.gridSteps << ",\n";
+  ss << "    \"timeStep\": " << config.erosion.timeStep << ",\n";
+  ss << "    \"rainRate\": " << config.erosion.rainRate << ",\n";
+  ss << "    \"convergence\": " << config.erosion.convergence << "\n";
+  ss << "  },\n";
+  ss << "  \"thermal\": {\n";
+  ss << "    \"iterations\": " << config.thermal.iterations << ",\n";
+  ss << "    \"talusAngle\": " << config.thermal.talusAngle << ",\n";
+  ss << "    \"rate\": " << config.thermal.rate << "\n";
   ss << "  }\n";
   ss << "}";
   return ss.str();
 }
 
 // Very simple manual JSON parser
-// Helper to extract value by key
-std::string GetValue(const std::string &data, const std::string &key) {
-  size_t pos = data.find("\"" + key + "\"");
-  if (pos == std::string::npos)
+// Helper to extract value by key from one of the top-level sections. Keys
+// repeat across sections ("seed"), so the search stays inside the section's
+// braces. Missing sections/keys give an empty string.
+std::string GetValue(const std::string &data, const std::string &section,
+                     const std::string &key) {
+  size_t sectionPos = data.find("\"" + section + "\"");
+  if (sectionPos == std::string::npos)
+    return "";
+  size_t sectionStart = data.find("{", sectionPos);
+  size_t sectionEnd = data.find("}", sectionStart);
+  if (sectionStart == std::string::npos || sectionEnd == std::string::npos)
+    return "";
+
+  size_t pos = data.find("\"" + key + "\"", sectionStart);
+  if (pos == std::string::npos || pos > sectionEnd)
     return "";
 
   size_t start = data.find(":", pos) + 1;
@@ -93,32 +143,74 @@ std::string GetValue(const std::string &data, const std::string &key) {
   return data.substr(start, end - start);
 }
 
+// Reads section.key into value if present; stoi/stof throw on garbage
+void ReadValue(const std::string &data, const std::string &section,
+               const std::string &key, int &value) {
+  std::string text = GetValue(data, section, key);
+  if (!text.empty())
+    value = std::stoi(text);
+}
+
+void ReadValue(const std::string &data, const std::string &section,
+               const std::string &key, float &value) {
+  std::string text = GetValue(data, section, key);
+  if (!text.empty())
+    value = std::stof(text);
+}
+
 bool Project::FromJSON(const std::string &data, ConfigSnapshot &outConfig) {
   try {
-    // This is a naive parser but works for our simple flat structure
-    std::string widthVal = GetValue(data, "width");
-    if (!widthVal.empty())
-      outConfig.terrain.width = std::stoi(widthVal);
-
-    std::string depthVal = GetValue(data, "depth");
-    if (!depthVal.empty())
-      outConfig.terrain.depth = std::stoi(depthVal);
-
-    std::string seedVal = GetValue(data, "seed");
-    if (!seedVal.empty())
-      outConfig.terrain.seed = std::stoi(seedVal);
-
-    std::string scaleVal = GetValue(data, "noiseScale");
-    if (!scaleVal.empty())
-      outConfig.terrain.noiseScale = std::stof(scaleVal);
-
-    std::string heightVal = GetValue(data, "heightMultiplier");
-    if (!heightVal.empty())
-      outConfig.terrain.heightMultiplier = std::stof(heightVal);
-
-    std::string seaVal = GetValue(data, "seaLevel");
-    if (!seaVal.empty())
-      outConfig.terrain.seaLevel = std::stof(seaVal);
+    // This is a naive parser but works for our simple one-level sections
+    auto &terrain = outConfig.terrain;
+    ReadValue(data, "terrain", "width", terrain.width);
+    ReadValue(data, "terrain", "depth", terrain.depth);
+    ReadValue(data, "terrain", "seed", terrain.seed);
+    ReadValue(data, "terrain", "noiseScale", terrain.noiseScale);
+    ReadValue(data, "terrain", "octaves", terrain.octaves);
+    ReadValue(data, "terrain", "lacunarity", terrain.lacunarity);
+    ReadValue(data, "terrain", "gain", terrain.gain);
+    ReadValue(data, "terrain", "heightMultiplier", terrain.heightMultiplier);
+    ReadValue(data, "terrain", "seaLevel", terrain.seaLevel);
+
+    // Older projects lack the later sections and keep the defaults
+    auto &rivers = outConfig.rivers;
+    ReadValue(data, "rivers", "riverCount", rivers.riverCount);
+    ReadValue(data, "rivers", "minRiverLength", rivers.minRiverLength);
+    ReadValue(data, "rivers", "minSourceHeight", rivers.minSourceHeight);
+    ReadValue(data, "rivers", "seed", rivers.seed);
+    int riverMethod = (int)rivers.method;
+    ReadValue(data, "rivers", "method", riverMethod);
+    rivers.method = (Generator::RiverGenerator::Method)riverMethod;
+    ReadValue(data, "rivers", "minCatchment", rivers.minCatchment);
+    ReadValue(data, "rivers", "minLakeCells", rivers.minLakeCells);
+    ReadValue(data, "rivers", "widthScale", rivers.widthScale);
+
+    auto &erosion = outConfig.erosion;
+    ReadValue(data, "erosion", "iterations", erosion.iterations);
+    ReadValue(data, "erosion", "erosionRate", erosion.erosionRate);
+    ReadValue(data, "erosion", "depositionRate", erosion.depositionRate);
+    ReadValue(data, "erosion", "gravity", erosion.gravity);
+    ReadValue(data, "erosion", "evaporationRate", erosion.evaporationRate);
+    ReadValue(data, "erosion", "erosionRadius", erosion.erosionRadius);
+    ReadValue(data, "erosion", "maxLifetime", erosion.maxLifetime);
+    ReadValue(data, "erosion", "inertia", erosion.inertia);
+    ReadValue(data, "erosion", "startSpeed", erosion.startSpeed);
+    ReadValue(data, "erosion", "startWater", erosion.startWater);
+    ReadValue(data, "erosion", "minSlope", erosion.minSlope);
+    ReadValue(data, "erosion", "capacityFactor", erosion.capacityFactor);
+    ReadValue(data, "erosion", "seed", erosion.seed);
+    int method = (int)erosion.method;
+    ReadValue(data, "erosion", "method", method);
+    erosion.method = (Generator::ErosionGenerator::Method)method;
+    ReadValue(data, "erosion", "gridSteps", erosion.gridSteps);
+    ReadValue(data, "erosion", "timeStep", erosion.timeStep);
+    ReadValue(data, "erosion", "rainRate", erosion.rainRate);
+    ReadValue(data, "erosion", "convergence", erosion.convergence);
+
+    auto &thermal = outConfig.thermal;
+    ReadValue(data, "thermal", "iterations", thermal.iterations);
+    ReadValue(data, "thermal", "talusAngle", thermal.talusAngle);
+    ReadValue(data, "thermal", "rate", thermal.rate);
 
     return true;
   } catch (...) {
@@ -1,5 +1,8 @@
 #pragma once
+#include "../Generator/ErosionGenerator.h"
+#include "../Generator/RiverGenerator.h"
 #include "../Generator/TerrainGenerator.h"
+#include "../Generator/ThermalErosionGenerator.h"
 #include "World.h"
 #include <string>
 #include <vector>
@@ -21,6 +24,9 @@ public:
 
   struct ConfigSnapshot {
     Genesis::Generator::TerrainGenerator::Config terrain;
+    Genesis::Generator::RiverGenerator::Config rivers;
+    Genesis::Generator::ErosionGenerator::Config erosion;
+    Genesis::Generator::ThermalErosionGenerator::Config thermal;
     // Add Tensor/Road configs here later
   };
 
@@ -0,0 +1,82 @@
+#include "RiverNetwork.h"
+#include <algorithm>
+
+namespace Genesis::Data {
+
+namespace {
+
+bool Overlaps(Core::Vec2 aMin, Core::Vec2 aMax, Core::Vec2 bMin,
+              Core::Vec2 bMax) {
+  return aMin.x <= bMax.x && bMin.x <= aMax.x && aMin.y <= bMax.y &&
+         bMin.y <= aMax.y;
+}
+
+float Cross(Core::Vec2 a, Core::Vec2 b) { return a.x * b.y - a.y * b.x; }
+
+} // namespace
+
+int32_t RiverNetwork::FindNearestNode(Core::Vec2 p, float maxDistance) const {
+  int32_t nearest = -1;
+  float best = maxDistance * maxDistance;
+  for (const Segment &segment : segments) {
+    if (!Overlaps({p.x - maxDistance, p.y - maxDistance},
+                  {p.x + maxDistance, p.y + maxDistance}, segment.min,
+                  segment.max))
+      continue;
+    for (int32_t i : segment.nodes) {
+      float dx = nodes[i].position.x - p.x;
+      float dy = nodes[i].position.y - p.y;
+      float d = dx * dx + dy * dy;
+      if (d <= best) {
+        best = d;
+        nearest = i;
+      }
+    }
+  }
+  return nearest;
+}
+
+std::vector<RiverNetwork::Crossing>
+RiverNetwork::FindCrossings(Core::Vec2 a, Core::Vec2 b) const {
+  std::vector<Crossing> crossings;
+  Core::Vec2 lineMin = {std::min(a.x, b.x), std::min(a.y, b.y)};
+  Core::Vec2 lineMax = {std::max(a.x, b.x), std::max(a.y, b.y)};
+  Core::Vec2 ab = {b.x - a.x, b.y - a.y};
+
+  for (const Segment &segment : segments) {
+    if (!Overlaps(lineMin, lineMax, segment.min, segment.max))
+      continue;
+    for (int32_t i : segment.nodes) {
+      const Node &from = nodes[i];
+      if (from.downstream < 0)
+        continue;
+      const Node &to = nodes[from.downstream];
+
+      // a + t * ab == from + u * edge, both within [0, 1]
+      Core::Vec2 edge = {to.position.x - from.position.x,
+                         to.position.y - from.position.y};
+      float denom = Cross(ab, edge);
+      if (denom == 0.0f)
+        continue; // Parallel
+      Core::Vec2 offset = {from.position.x - a.x, from.position.y - a.y};
+      float t = Cross(offset, edge) / denom;
+      float u = Cross(offset, ab) / denom;
+      // Half-open along the river, so a line through a node counts once
+      if (t < 0.0f || t > 1.0f || u < 0.0f || u >= 1.0f)
+        continue;
+
+      Crossing crossing;
+      crossing.node = i;
+      crossing.t = t;
+      crossing.point = {a.x + ab.x * t, a.y + ab.y * t};
+      crossing.width = from.width + (to.width - from.width) * u;
+      crossings.push_back(crossing);
+    }
+  }
+
+  std::sort(crossings.begin(), crossings.end(),
+            [](const Crossing &l, const Crossing &r) { return l.t < r.t; });
+  return crossings;
+}
+
+} // namespace Genesis::Data
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../Core/Math.h"
+#include <cstdint>
+#include <vector>
+
+namespace Genesis::Data {
+
+// Rivers as a graph (see Generator::RiverGenerator): one node per river
+// cell, each pointing at the node it flows into, grouped into segments that
+// run from a source or confluence to the next confluence or the mouth.
+// Positions, lengths and widths are in world units (grid * Terrain::scale).
+struct RiverNetwork {
+  struct Node {
+    Core::Vec2 position;
+    float height = 0.0f;      // Raw height (the surface, on lakes)
+    float discharge = 0.0f;   // Catchment area draining through, world units^2
+    float width = 0.0f;       // Channel width
+    int32_t downstream = -1;  // Node this one flows into, -1 at the mouth
+    int32_t segment = -1;     // Segment the node belongs to
+    int32_t upstreamCount = 0; // 0 = source, 2+ = confluence
+  };
+
+  struct Segment {
+    // Upstream to downstream. A segment ending at a confluence doesn't
+    // include it; the confluence is the first node of `downstream`.
+    std::vector<int32_t> nodes;
+    int32_t downstream = -1; // -1 when the segment reaches the mouth
+    int order = 1;           // Strahler order
+    // Bounds of the segment's edges (its nodes and the one it flows into),
+    // for spatial queries
+    Core::Vec2 min;
+    Core::Vec2 max;
+  };
+
+  // A road (or any line) crossing a river, see FindCrossings
+  struct Crossing {
+    int32_t node = -1; // Upstream end of the crossed edge
+    float t = 0.0f;    // Position along the query line (0 = a, 1 = b)
+    Core::Vec2 point;
+    float width = 0.0f; // Channel width at the crossing
+  };
+
+  std::vector<Node> nodes;
+  std::vector<Segment> segments;
+
+  bool IsEmpty() const { return nodes.empty(); }
+  void Clear() {
+    nodes.clear();
+    segments.clear();
+  }
+
+  // Nearest node within maxDistance of p, or -1
+  int32_t FindNearestNode(Core::Vec2 p, float maxDistance) const;
+
+  // Every river edge the line a-b crosses, ordered from a to b
+  std::vector<Crossing> FindCrossings(Core::Vec2 a, Core::Vec2 b) const;
+
+  // Calls fn(nodeIndex) for `node` and everything downstream of it, until
+  // the mouth or until fn returns false
+  template <typename Fn> void WalkDownstream(int32_t node, Fn &&fn) const {
+    for (; node >= 0; node = nodes[node].downstream)
+      if (!fn(node))
+        return;
+  }
+};
+
+} // namespace Genesis::Data
@@ -0,0 +1,87 @@
+#include "StageLayer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Genesis::Data {
+
+void StageLayer::Clear() {
+  tiles.clear();
+  width = 0;
+  depth = 0;
+  tilesX = 0;
+}
+
+void StageLayer::GetTileBounds(int t, int &x0, int &z0, int &x1,
+                               int &z1) const {
+  x0 = (t % tilesX) * TileSize;
+  z0 = (t / tilesX) * TileSize;
+  x1 = std::min(x0 + TileSize, width);
+  z1 = std::min(z0 + TileSize, depth);
+}
+
+bool StageLayer::TileEquals(const Tile &tile, const std::vector<float> &grid,
+                            int t) const {
+  int x0, z0, x1, z1;
+  GetTileBounds(t, x0, z0, x1, z1);
+  int tileWidth = x1 - x0;
+  // Bitwise, so restoring a tile that compares equal is a no-op
+  for (int z = z0; z < z1; z++) {
+    if (std::memcmp(tile.data() + (z - z0) * tileWidth,
+                    grid.data() + z * width + x0,
+                    tileWidth * sizeof(float)) != 0)
+      return false;
+  }
+  return true;
+}
+
+void StageLayer::Capture(const std::vector<float> &grid, int gridWidth,
+                         int gridDepth, const StageLayer *parent) {
+  if (parent && !parent->Matches(gridWidth, gridDepth))
+    parent = nullptr;
+
+  width = gridWidth;
+  depth = gridDepth;
+  tilesX = (width + TileSize - 1) / TileSize;
+  int tilesZ = (depth + TileSize - 1) / TileSize;
+  tiles.assign(tilesX * tilesZ, nullptr);
+
+  for (int t = 0; t < (int)tiles.size(); t++) {
+    if (parent && parent->TileEquals(*parent->tiles[t], grid, t)) {
+      tiles[t] = parent->tiles[t];
+      continue;
+    }
+
+    int x0, z0, x1, z1;
+    GetTileBounds(t, x0, z0, x1, z1);
+    int tileWidth = x1 - x0;
+    auto tile = std::make_shared<Tile>(tileWidth * (z1 - z0));
+    for (int z = z0; z < z1; z++)
+      std::copy_n(grid.data() + z * width + x0, tileWidth,
+                  tile->data() + (z - z0) * tileWidth);
+    tiles[t] = std::move(tile);
+  }
+}
+
+GridRegion StageLayer::Restore(std::vector<float> &grid) const {
+  GridRegion changed;
+  if (IsEmpty())
+    return changed;
+  grid.resize(width * depth);
+
+  for (int t = 0; t < (int)tiles.size(); t++) {
+    const Tile &tile = *tiles[t];
+    if (TileEquals(tile, grid, t))
+      continue;
+
+    int x0, z0, x1, z1;
+    GetTileBounds(t, x0, z0, x1, z1);
+    int tileWidth = x1 - x0;
+    for (int z = z0; z < z1; z++)
+      std::copy_n(tile.data() + (z - z0) * tileWidth, tileWidth,
+                  grid.data() + z * width + x0);
+    changed.Include({x0, z0, x1 - 1, z1 - 1});
+  }
+  return changed;
+}
+
+} // namespace Genesis::Data
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "GridRegion.h"
+#include <memory>
+#include <vector>
+
+namespace Genesis::Data {
+
+// Snapshot of a float grid, stored as square tiles. Tiles are immutable and
+// shared between layers (copy-on-write): a layer captured from a grid that
+// only differs from its parent layer in a few places allocates just those
+// tiles and points at the parent's for the rest. Copying a layer (e.g. with
+// the terrain into a staging world) only copies tile pointers.
+class StageLayer {
+public:
+  static constexpr int TileSize = 64;
+
+  bool IsEmpty() const { return tiles.empty(); }
+  bool Matches(int gridWidth, int gridDepth) const {
+    return !IsEmpty() && width == gridWidth && depth == gridDepth;
+  }
+  void Clear();
+
+  // Stores `grid` (width * depth, row-major). Tiles whose contents equal the
+  // same tile of `parent` (when it has the same size) are shared with it
+  // instead of copied.
+  void Capture(const std::vector<float> &grid, int gridWidth, int gridDepth,
+               const StageLayer *parent = nullptr);
+
+  // Writes the layer back into `grid`, copying only the tiles that differ.
+  // Returns the cells that changed (empty if none did).
+  GridRegion Restore(std::vector<float> &grid) const;
+
+private:
+  using Tile = std::vector<float>;
+
+  // Cells of tile t: [x0, x1) x [z0, z1)
+  void GetTileBounds(int t, int &x0, int &z0, int &x1, int &z1) const;
+  bool TileEquals(const Tile &tile, const std::vector<float> &grid,
+                  int t) const;
+
+  int width = 0;
+  int depth = 0;
+  int tilesX = 0;
+  std::vector<std::shared_ptr<const Tile>> tiles;
+};
+
+} // namespace Genesis::Data
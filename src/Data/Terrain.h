@@ -1,26 +1,48 @@
 #pragma once
 
-#include "raylib.h"
+#include "GridLayer.h"
+#include "GridRegion.h"
+#include "StageLayer.h"
+#include <cstdint>
 #include <vector>
 
 namespace Genesis::Data {
 
+// A depression that holds water (see Generator::Hydrology::FindLakes)
+struct Lake {
+  float level = 0.0f; // Raw water surface height
+  int spillX = 0;     // Rim cell the lake overflows through
+  int spillZ = 0;
+  int cells = 0;
+};
+
 struct Terrain {
   int width = 0;
   int depth = 0;
-  float scale = 1.0f;
+  float scale = 1.0f; // World units between neighbouring samples
 
   // The raw height data (0.0f - 1.0f)
   std::vector<float> heightMap;
-  std::vector<float> baseHeightMap;       // Original heightmap for resetting
-  std::vector<float> preErosionHeightMap; // Snapshot before erosion
-  // 0 = No River, 1 = River Source, 2 = River Body
-  std::vector<int> riverMap;
+  // Stage snapshots that re-runs restart from. Each one shares the tiles it
+  // didn't change with the stage before it (see StageLayer).
+  StageLayer baseHeightMap;       // Generated heightmap, restored by rivers
+  StageLayer preErosionHeightMap; // Before erosion (base + river carving)
+  StageLayer preThermalHeightMap; // Before thermal erosion
+  // Attribute layers, sized width * depth (see GridLayer)
+  // 0 = No River, 1 = River Source, 2 = River Body, 3 = Lake
+  GridLayer<uint8_t> riverMap;
+  // 0 = no lake, else 1 + index into lakes
+  GridLayer<uint16_t> lakeMap;
+  std::vector<Lake> lakes;
+
+  // World-space height of a raw 1.0 and the water line, as last applied by a
+  // generator. Viewers (the editor's terrain mesh, exporters) scale with these.
+  float heightMultiplier = 10.0f;
+  float seaLevel = 0.2f;
 
-  // The visual representation
-  Mesh mesh = {0};
-  Model model = {0};
-  bool isModelLoaded = false;
+  // Cells changed since a viewer last caught up (see Render::TerrainMesh).
+  // Writers that bypass SetHeight mark what they touched with MarkDirty.
+  GridRegion dirty;
 
   // Helper to get height at integer coordinates
   float GetHeight(int x, int z) const {
@@ -29,27 +51,24 @@ struct Terrain {
     return heightMap[z * width + x];
   }
 
-  int GetRiverType(int x, int z) const {
-    if (x < 0 || x >= width || z < 0 || z >= depth || riverMap.empty())
-      return 0;
-    return riverMap[z * width + x];
+  int GetRiverType(int x, int z) const { return riverMap.Get(x, z); }
+
+  // Empty river map at the current size, no lakes
+  void ClearRivers() {
+    riverMap.Assign(width, depth, 0);
+    lakeMap.Clear();
+    lakes.clear();
   }
 
   void SetHeight(int x, int z, float h) {
     if (x < 0 || x >= width || z < 0 || z >= depth)
       return;
     heightMap[z * width + x] = h;
+    dirty.Include(x, z);
   }
 
-  // Destructor to clean up GPU resources
-  ~Terrain() {
-    if (isModelLoaded) {
-      UnloadModel(model);
-      // UnloadModel unloads meshes too usually, depending on how they were
-      // created Raylib's GenMeshHeightmap ownership is tricky. We'll trust
-      // Raylib's UnloadModel for now.
-    }
-  }
+  void MarkDirty(const GridRegion &region) { dirty.Include(region); }
+  void MarkAllDirty() { dirty = GridRegion::Full(width, depth); }
 };
 
 } // namespace Genesis::Data
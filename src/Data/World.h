@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Generator/TensorField.h" // We'll move this to Data later or wrap it here
+#include "RiverNetwork.h"
 #include "Terrain.h"
 #include <memory>
 
@@ -10,6 +11,8 @@ namespace Genesis::Data {
 struct World {
   // Step 1: Macro
   std::shared_ptr<Terrain> terrain;
+  // Rivers of the terrain as a graph, alongside Terrain::riverMap
+  std::shared_ptr<RiverNetwork> riverNetwork;
 
   // Step 2: Infrastructure
   // Currently utilizing the existing class, but technically it's acting as Data
@@ -18,6 +21,7 @@ struct World {
 
   World() {
     terrain = std::make_shared<Terrain>();
+    riverNetwork = std::make_shared<RiverNetwork>();
     tensorField = std::make_shared<Genesis::Generator::TensorField>(100, 100);
   }
 };
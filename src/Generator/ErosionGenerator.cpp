@@ -1,184 +1,723 @@
 #include "ErosionGenerator.h"
+#include "../Core/Profiler.h"
+#include "../Core/Random.h"
+#include "../Core/Simd.h"
+#include "../Core/ThreadPool.h"
 #include <algorithm>
 #include <cmath>
-#include <random>
+#include <mutex>
+#include <type_traits>
+#include <vector>
 
 namespace Genesis::Generator {
 
 void ErosionGenerator::Execute(Data::World &world, const Config &config,
-                               const TerrainGenerator::Config &terrainConfig) {
+                               const TerrainGenerator::Config &terrainConfig,
+                               Core::JobProgress *progress) {
+  GENESIS_PROFILE_SCOPE("Erosion/Execute");
   if (!world.terrain)
     return;
   auto terrain = world.terrain.get();
 
+  bool finished = true;
+  if (config.method == Method::Grid) {
+    PrepareRun(terrain);
+    if (terrain->width < 3 || terrain->depth < 3)
+      return;
+    finished = RunGrid(terrain, config, progress);
+  } else {
+    Session session(world.terrain, config);
+    finished = session.Run(progress);
+  }
+  if (finished)
+    TerrainGenerator::ApplyDisplaySettings(terrain, terrainConfig);
+}
+
+void ErosionGenerator::PrepareRun(Data::Terrain *terrain) {
   // We modify terrain->heightMap directly
   // Snapshot logic to prevent additive erosion on repeated runs
-  if (terrain->preErosionHeightMap.empty() ||
-      terrain->preErosionHeightMap.size() != terrain->heightMap.size()) {
+  if (!terrain->preErosionHeightMap.Matches(terrain->width, terrain->depth)) {
     // First run (or after river reset), take snapshot of CURRENT state (which
-    // includes rivers)
-    terrain->preErosionHeightMap = terrain->heightMap;
+    // includes rivers). Only the tiles rivers carved differ from the base.
+    terrain->preErosionHeightMap.Capture(terrain->heightMap, terrain->width,
+                                         terrain->depth,
+                                         &terrain->baseHeightMap);
   } else {
     // Repeated run, restore from snapshot
-    terrain->heightMap = terrain->preErosionHeightMap;
+    terrain->MarkDirty(
+        terrain->preErosionHeightMap.Restore(terrain->heightMap));
+  }
+  // Thermal erosion runs on top of this, so its snapshot is stale now
+  terrain->preThermalHeightMap.Clear();
+}
+
+ErosionGenerator::Session::Session(std::shared_ptr<Data::Terrain> terrain,
+                                   const Config &config)
+    : terrain(std::move(terrain)), config(config),
+      random((uint64_t)(uint32_t)config.seed),
+      target(std::max(config.iterations, 0)) {
+  Data::Terrain *t = this->terrain.get();
+  PrepareRun(t);
+  int width = t->width;
+  int depth = t->depth;
+  if (width < 3 || depth < 3) {
+    target = 0;
+    return;
   }
 
+  if (config.erosionRadius > 0)
+    brush = GetBrush(width, depth, config.erosionRadius);
+
+  // A droplet moves at most one cell per axis per step and reads/writes the
+  // cell after its position (plus the brush), so it stays within `reach`
+  // cells of its start. Tiles of one phase are a whole tile apart, which
+  // keeps them independent.
+  int reach = (int)std::ceil(config.maxLifetime) + 1 +
+              std::max(config.erosionRadius, 0);
+  tileSize = std::max(MinTileSize, 2 * reach);
+  tilesX = (width + tileSize - 1) / tileSize;
+  tilesZ = (depth + tileSize - 1) / tileSize;
+  tileStart.resize(tilesX * tilesZ + 1);
+  touched.resize(tilesX * tilesZ);
+}
+
+int ErosionGenerator::Session::Step(int maxDroplets) {
+  int run = 0;
+  while (run < maxDroplets && done < target) {
+    int count = std::min({RoundSize, maxDroplets - run, target - done});
+    RunRound(count);
+    run += count;
+    done += count;
+  }
+
+  // Viewers only refresh what the droplets wrote to
+  for (Data::GridRegion &region : touched) {
+    terrain->MarkDirty(region);
+    region = {};
+  }
+  return run;
+}
+
+bool ErosionGenerator::Session::Run(Core::JobProgress *progress) {
+  GENESIS_PROFILE_SCOPE("Erosion/Droplets");
+  while (!IsFinished()) {
+    if (progress) {
+      if (progress->IsCancelled())
+        return false;
+      progress->Set((float)done / target);
+    }
+    Step(RoundSize);
+  }
+  return true;
+}
+
+void ErosionGenerator::Session::Continue(int droplets) {
+  target = done + std::max(droplets, 0);
+}
+
+void ErosionGenerator::Session::RunRound(int count) {
+  Data::Terrain *t = terrain.get();
+  int tileCount = tilesX * tilesZ;
+  float spawnWidth = (float)t->width - 1.1f;
+  float spawnDepth = (float)t->depth - 1.1f;
+  auto tileOf = [&](const Spawn &spawn) {
+    return ((int)spawn.z / tileSize) * tilesX + (int)spawn.x / tileSize;
+  };
+
+  // Spawn the round's droplets and sort them by tile, keeping spawn order
+  // within each tile (counting sort)
+  spawns.resize(count);
+  std::fill(tileStart.begin(), tileStart.end(), 0);
+  for (Spawn &spawn : spawns) {
+    spawn.x = random.NextFloat() * spawnWidth;
+    spawn.z = random.NextFloat() * spawnDepth;
+    tileStart[tileOf(spawn) + 1]++;
+  }
+  for (int tile = 0; tile < tileCount; tile++)
+    tileStart[tile + 1] += tileStart[tile];
+  bucketed.resize(count);
+  {
+    std::vector<int> next(tileStart.begin(), tileStart.end() - 1);
+    for (const Spawn &spawn : spawns)
+      bucketed[next[tileOf(spawn)]++] = spawn;
+  }
+
+  for (int phase = 0; phase < 4; phase++) {
+    phaseTiles.clear();
+    for (int tz = phase >> 1; tz < tilesZ; tz += 2)
+      for (int tx = phase & 1; tx < tilesX; tx += 2)
+        if (tileStart[tz * tilesX + tx + 1] > tileStart[tz * tilesX + tx])
+          phaseTiles.push_back(tz * tilesX + tx);
+
+    auto runTile = [&](int i) {
+      int tile = phaseTiles[i];
+      for (int d = tileStart[tile]; d < tileStart[tile + 1]; d += BatchSize)
+        SimulateBatch(t, config, brush.get(), &bucketed[d],
+                      std::min(BatchSize, tileStart[tile + 1] - d),
+                      touched[tile]);
+    };
+    if (config.parallel) {
+      Core::ThreadPool::Get().ParallelFor((int)phaseTiles.size(), runTile);
+    } else {
+      for (int i = 0; i < (int)phaseTiles.size(); i++)
+        runTile(i);
+    }
+  }
+}
+
+namespace {
+
+using namespace Genesis::Core::Simd;
+
+// Lockstep droplet state, one array entry per droplet of a batch
+struct DropletLanes {
+  static constexpr int Size = 8;
+
+  alignas(32) float x[Size];
+  alignas(32) float z[Size];
+  alignas(32) float dirX[Size];
+  alignas(32) float dirZ[Size];
+  alignas(32) float speed[Size];
+  alignas(32) float water[Size];
+  alignas(32) float sediment[Size];
+  alignas(32) int32_t alive[Size]; // All bits set while the droplet lives
+
+  // This step's result for the write-back: the node and cell offsets the
+  // droplet left, and the sediment it picked up (negative when depositing).
+  // Only set where `wrote` is.
+  alignas(32) int32_t node[Size];
+  alignas(32) float u[Size];
+  alignas(32) float v[Size];
+  alignas(32) float pickedUp[Size];
+  alignas(32) int32_t wrote[Size];
+};
+
+// Bilinear height and gradient of the cell at `index` with offsets (u, v).
+// The four corners are gathered once for both.
+template <int W>
+void SampleHeight(const float *heights, int width, Int<W> index, Float<W> u,
+                  Float<W> v, Float<W> &h, Float<W> &gx, Float<W> &gz) {
+  Float<W> one(1.0f);
+  Float<W> h00 = Gather(heights, index);
+  Float<W> h10 = Gather(heights, index + Int<W>(1));
+  Float<W> h01 = Gather(heights, index + Int<W>(width));
+  Float<W> h11 = Gather(heights, index + Int<W>(width + 1));
+  gx = (h10 - h00) * (one - v) + (h11 - h01) * v;
+  gz = (h01 - h00) * (one - u) + (h11 - h10) * u;
+  h = h00 * (one - u) * (one - v) + h10 * u * (one - v) +
+      h01 * (one - u) * v + h11 * u * v;
+}
+
+// Moves lanes [lane, lane + W) one step and works out how much sediment
+// each one erodes or deposits. Heights are only read here.
+template <int W>
+void AdvanceDroplets(DropletLanes &lanes, int lane, const float *heights,
+                     int width, int depth,
+                     const ErosionGenerator::Config &config) {
+  Float<W> zero(0.0f);
+  Float<W> one(1.0f);
+  Float<W> alive = AsFloat(Int<W>::Load(lanes.alive + lane));
+  Float<W> x = Float<W>::Load(lanes.x + lane);
+  Float<W> z = Float<W>::Load(lanes.z + lane);
+
+  // Positions are never negative, so truncating is flooring
+  Int<W> nodeX = ToInt(x);
+  Int<W> nodeZ = ToInt(z);
+  Float<W> u = x - ToFloat(nodeX);
+  Float<W> v = z - ToFloat(nodeZ);
+  Int<W> node = nodeZ * Int<W>(width) + nodeX;
+
+  Float<W> heightOld, gx, gz;
+  SampleHeight<W>(heights, width, node, u, v, heightOld, gx, gz);
+
+  // Update and normalize the direction
+  Float<W> inertia(config.inertia);
+  Float<W> dirX = Float<W>::Load(lanes.dirX + lane) * inertia -
+                  gx * (one - inertia);
+  Float<W> dirZ = Float<W>::Load(lanes.dirZ + lane) * inertia -
+                  gz * (one - inertia);
+  Float<W> len = Sqrt(dirX * dirX + dirZ * dirZ);
+  Float<W> moving = len > zero;
+  dirX = Select(moving, dirX / len, dirX);
+  dirZ = Select(moving, dirZ / len, dirZ);
+
+  // Move; droplets leaving the map die before they write anything
+  Float<W> newX = x + dirX;
+  Float<W> newZ = z + dirZ;
+  Float<W> inside =
+      And(And(newX >= zero, newX < Float<W>((float)(width - 1))),
+          And(newZ >= zero, newZ < Float<W>((float)(depth - 1))));
+  alive = And(alive, inside);
+  // Dead lanes keep sampling their last cell, which is always in range
+  newX = Select(alive, newX, x);
+  newZ = Select(alive, newZ, z);
+
+  Int<W> newNodeX = ToInt(newX);
+  Int<W> newNodeZ = ToInt(newZ);
+  Float<W> heightNew, unusedX, unusedZ;
+  SampleHeight<W>(heights, width, newNodeZ * Int<W>(width) + newNodeX,
+                  newX - ToFloat(newNodeX), newZ - ToFloat(newNodeZ),
+                  heightNew, unusedX, unusedZ);
+  Float<W> deltaH = heightNew - heightOld;
+
+  // Steeper slope + faster speed = more capacity
+  Float<W> speed = Float<W>::Load(lanes.speed + lane);
+  Float<W> water = Float<W>::Load(lanes.water + lane);
+  Float<W> sediment = Float<W>::Load(lanes.sediment + lane);
+  Float<W> capacity = Max(zero - deltaH, Float<W>(config.minSlope)) * speed *
+                      water * Float<W>(config.capacityFactor);
+
+  // Over capacity (or moving uphill, which dumps sediment to fill the pit)
+  // deposits; otherwise erode, no deeper than the step down
+  Float<W> uphill = deltaH > zero;
+  Float<W> deposit = Or(sediment > capacity, uphill);
+  Float<W> deposited =
+      Select(uphill, Min(deltaH, sediment),
+             (sediment - capacity) * Float<W>(config.depositionRate));
+  Float<W> eroded = Min((capacity - sediment) * Float<W>(config.erosionRate),
+                        zero - deltaH);
+  Float<W> pickedUp = Select(deposit, zero - deposited, eroded);
+
+  speed = Sqrt(Max(zero, speed * speed + deltaH * Float<W>(config.gravity)));
+  water = water * Float<W>(1.0f - config.evaporationRate);
+
+  newX.Store(lanes.x + lane);
+  newZ.Store(lanes.z + lane);
+  dirX.Store(lanes.dirX + lane);
+  dirZ.Store(lanes.dirZ + lane);
+  speed.Store(lanes.speed + lane);
+  water.Store(lanes.water + lane);
+  Select(alive, sediment + pickedUp, sediment).Store(lanes.sediment + lane);
+
+  node.Store(lanes.node + lane);
+  u.Store(lanes.u + lane);
+  v.Store(lanes.v + lane);
+  pickedUp.Store(lanes.pickedUp + lane);
+  AsInt(alive).Store(lanes.wrote + lane);
+  AsInt(And(alive, water >= Float<W>(0.01f))).Store(lanes.alive + lane);
+}
+
+} // namespace
+
+void ErosionGenerator::SimulateBatch(Data::Terrain *terrain,
+                                     const Config &config, const Brush *brush,
+                                     const Spawn *spawns, int count,
+                                     Data::GridRegion &touched) {
+  static_assert(DropletLanes::Size == BatchSize);
+  constexpr int W = NativeWidth <= BatchSize ? NativeWidth : 1;
   int width = terrain->width;
   int depth = terrain->depth;
+  float *heights = terrain->heightMap.data();
+  int radius = brush ? brush->radius : 0;
 
-  // Random setup
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_real_distribution<float> disX(0.0f, (float)width - 1.1f);
-  std::uniform_real_distribution<float> disZ(0.0f, (float)depth - 1.1f);
-
-  for (int iter = 0; iter < config.iterations; iter++) {
-    // Spawn Droplet
-    Droplet drop;
-    drop.x = disX(gen);
-    drop.z = disZ(gen);
-    drop.dirX = 0;
-    drop.dirZ = 0;
-    drop.speed = config.startSpeed;
-    drop.water = config.startWater;
-    drop.sediment = 0;
-
-    for (int step = 0; step < config.maxLifetime; step++) {
-      int nodeX = (int)drop.x;
-      int nodeZ = (int)drop.z;
-      float cellOffsetX = drop.x - nodeX;
-      float cellOffsetZ = drop.z - nodeZ;
-
-      // Get gradient
-      float gx, gz;
-      GetGradient(terrain, drop.x, drop.z, gx, gz);
-
-      // Update Direction
-      drop.dirX = (drop.dirX * config.inertia - gx * (1 - config.inertia));
-      drop.dirZ = (drop.dirZ * config.inertia - gz * (1 - config.inertia));
-
-      // Normalize direction
-      float len = std::sqrt(drop.dirX * drop.dirX + drop.dirZ * drop.dirZ);
-      if (len != 0) {
-        drop.dirX /= len;
-        drop.dirZ /= len;
-      }
-
-      // Move
-      drop.x += drop.dirX;
-      drop.z += drop.dirZ;
+  // Unused lanes start dead at cell 0, so their gathers stay in range
+  DropletLanes lanes;
+  for (int i = 0; i < BatchSize; i++) {
+    bool used = i < count;
+    lanes.x[i] = used ? spawns[i].x : 0.0f;
+    lanes.z[i] = used ? spawns[i].z : 0.0f;
+    lanes.dirX[i] = 0.0f;
+    lanes.dirZ[i] = 0.0f;
+    lanes.speed[i] = config.startSpeed;
+    lanes.water[i] = config.startWater;
+    lanes.sediment[i] = 0.0f;
+    lanes.alive[i] = used ? -1 : 0;
+  }
 
-      // Check bounds
-      if (drop.x < 0 || drop.x >= width - 1 || drop.z < 0 ||
-          drop.z >= depth - 1) {
-        break;
-      }
+  for (int step = 0; step < config.maxLifetime; step++) {
+    for (int lane = 0; lane < BatchSize; lane += W)
+      AdvanceDroplets<W>(lanes, lane, heights, width, depth, config);
 
-      // Calculate height difference
-      float heightOld = GetHeightInterpolated(terrain, nodeX + cellOffsetX,
-                                              nodeZ + cellOffsetZ);
-      float heightNew = GetHeightInterpolated(terrain, drop.x, drop.z);
-      float deltaH = heightNew - heightOld;
-
-      // Calculate Capacity
-      // Capacity is steeper slope + faster speed = more capacity
-      float sedimentCapacity = std::max(-deltaH, config.minSlope) * drop.speed *
-                               drop.water * config.capacityFactor;
-
-      // Erosion or Deposition
-      if (drop.sediment > sedimentCapacity || deltaH > 0) {
-        // Deposit
-        float amountToDeposit =
-            (drop.sediment - sedimentCapacity) * config.depositionRate;
-        if (deltaH > 0) {
-          // Moving uphill? Dump all sediment to fill pit
-          amountToDeposit = std::min(deltaH, drop.sediment);
-        }
-
-        drop.sediment -= amountToDeposit;
-
-        // Add to heightmap (bilinear)
-        // We add to the 4 nodes around old pos
-        terrain->heightMap[nodeZ * width + nodeX] +=
-            amountToDeposit * (1 - cellOffsetX) * (1 - cellOffsetZ);
-        terrain->heightMap[nodeZ * width + (nodeX + 1)] +=
-            amountToDeposit * cellOffsetX * (1 - cellOffsetZ);
-        terrain->heightMap[(nodeZ + 1) * width + nodeX] +=
-            amountToDeposit * (1 - cellOffsetX) * cellOffsetZ;
-        terrain->heightMap[(nodeZ + 1) * width + (nodeX + 1)] +=
-            amountToDeposit * cellOffsetX * cellOffsetZ;
+    // Write back in batch order, so the result doesn't depend on W
+    bool anyWrote = false;
+    for (int i = 0; i < BatchSize; i++) {
+      if (!lanes.wrote[i])
+        continue;
+      anyWrote = true;
+      int node = lanes.node[i];
+      float u = lanes.u[i];
+      float v = lanes.v[i];
+      float amount = lanes.pickedUp[i];
+      int nodeX = node % width;
+      int nodeZ = node / width;
 
+      if (amount < 0.0f || !brush) {
+        // Deposition (and erosion without a brush) goes to the 4 nodes
+        // around the old position
+        float *h = heights + node;
+        h[0] -= amount * (1 - u) * (1 - v);
+        h[1] -= amount * u * (1 - v);
+        h[width] -= amount * (1 - u) * v;
+        h[width + 1] -= amount * u * v;
       } else {
-        // Erode
-        float amountToErode = std::min(
-            (sedimentCapacity - drop.sediment) * config.erosionRate, -deltaH);
-
-        // Don't erode more than deltaH (don't dig a pit deeper than the step)
-
-        // Apply erosion to nodes
-        // For better look, we could erode with a radius (brush), but simple
-        // bilinear is faster
-        terrain->heightMap[nodeZ * width + nodeX] -=
-            amountToErode * (1 - cellOffsetX) * (1 - cellOffsetZ);
-        terrain->heightMap[nodeZ * width + (nodeX + 1)] -=
-            amountToErode * cellOffsetX * (1 - cellOffsetZ);
-        terrain->heightMap[(nodeZ + 1) * width + nodeX] -=
-            amountToErode * (1 - cellOffsetX) * cellOffsetZ;
-        terrain->heightMap[(nodeZ + 1) * width + (nodeX + 1)] -=
-            amountToErode * cellOffsetX * cellOffsetZ;
-
-        drop.sediment += amountToErode;
+        // The brush spreads erosion over a disc around the node, which
+        // avoids the needle-like pits of the 4-node version
+        int base;
+        const int *indices;
+        const float *weights;
+        int taps = brush->Get(nodeX, nodeZ, base, indices, weights);
+        float *h = heights + base;
+        for (int t = 0; t < taps; t++)
+          h[indices[t]] -= amount * weights[t];
       }
 
-      // Update Speed & Water
-      float speedSq = drop.speed * drop.speed + deltaH * config.gravity;
-      drop.speed = std::sqrt(std::max(0.0f, speedSq));
-      drop.water *= (1 - config.evaporationRate);
+      touched.Include(std::max(nodeX - radius, 0),
+                      std::max(nodeZ - radius, 0));
+      touched.Include(std::min(nodeX + 1 + radius, width - 1),
+                      std::min(nodeZ + 1 + radius, depth - 1));
+    }
+    if (!anyWrote)
+      break;
+  }
+}
+
+namespace {
+
+// Below this water depth a cell counts as dry (no velocity, no sediment
+// carried out)
+constexpr float MinWaterDepth = 1e-4f;
+
+// Pipe-model state. Every layer covers the terrain grid plus a 1-cell border,
+// so stencils at the edges need no special cases. Border cells keep zero
+// water, sediment and flux; their height repeats the edge, so water (and the
+// sediment it carries) can flow off the map but never comes back.
+struct PipeGrid {
+  int width = 0;
+  int depth = 0;
+  int stride = 0; // width + 2
+
+  std::vector<float> height;
+  std::vector<float> water;
+  std::vector<float> sediment;
+  std::vector<float> sedimentNext;
+  std::vector<float> capacity;
+  std::vector<float> fluxL, fluxR, fluxT, fluxB; // Outflow per side
+  std::vector<float> rowChange; // Largest height change per row this step
+};
+
+struct PipeParams {
+  float dt;
+  float gravity;
+  float rain;
+  float evaporation;
+  float capacity;
+  float minTilt;
+  float dissolve;
+  float deposit;
+};
+
+template <int W> Float<W> Load(const std::vector<float> &layer, int i) {
+  return Float<W>::Load(layer.data() + i);
+}
+
+template <int W> Float<W> Abs(Float<W> a) {
+  return Max(a, Float<W>(0.0f) - a);
+}
 
-      if (drop.water < 0.01f)
-        break;
+template <int W> float HorizontalMax(Float<W> a) {
+  float m = a.Lane(0);
+  for (int l = 1; l < W; l++)
+    m = std::max(m, a.Lane(l));
+  return m;
+}
+
+// Runs kernel(lanes, i, z) over every interior cell, a row per task, in
+// blocks of NativeWidth cells plus a scalar tail. `lanes` is an
+// integral_constant holding the block width; `i` is the padded index of the
+// block's first cell.
+template <typename Kernel>
+void ForEachCell(const PipeGrid &grid, const Kernel &kernel) {
+  Genesis::Core::ThreadPool::Get().ParallelFor(grid.depth, [&](int z) {
+    int row = (z + 1) * grid.stride + 1;
+    int x = 0;
+    if constexpr (NativeWidth > 1) {
+      for (; x + NativeWidth <= grid.width; x += NativeWidth)
+        kernel(std::integral_constant<int, NativeWidth>(), row + x, z);
     }
+    for (; x < grid.width; x++)
+      kernel(std::integral_constant<int, 1>(), row + x, z);
+  });
+}
+
+// 1. Outflow flux to the 4 neighbours from the water surface difference,
+// scaled down where it would drain more than the cell holds
+template <int W> void PipeFlux(PipeGrid &g, const PipeParams &p, int i) {
+  auto surface = [&](int j) {
+    return Load<W>(g.height, j) + Load<W>(g.water, j);
+  };
+  Float<W> zero(0.0f);
+  Float<W> k(p.dt * p.gravity);
+  Float<W> h = surface(i);
+  Float<W> l = Max(zero, Load<W>(g.fluxL, i) + k * (h - surface(i - 1)));
+  Float<W> r = Max(zero, Load<W>(g.fluxR, i) + k * (h - surface(i + 1)));
+  Float<W> t =
+      Max(zero, Load<W>(g.fluxT, i) + k * (h - surface(i - g.stride)));
+  Float<W> b =
+      Max(zero, Load<W>(g.fluxB, i) + k * (h - surface(i + g.stride)));
+
+  Float<W> water = Load<W>(g.water, i);
+  Float<W> out = (l + r + t + b) * Float<W>(p.dt);
+  Float<W> scale = Select(out > water, water / out, Float<W>(1.0f));
+  (l * scale).Store(g.fluxL.data() + i);
+  (r * scale).Store(g.fluxR.data() + i);
+  (t * scale).Store(g.fluxT.data() + i);
+  (b * scale).Store(g.fluxB.data() + i);
+}
+
+// 2. Sediment moves with the water: every flux carries its source cell's
+// concentration (sediment / water). Upwind and mass-conserving, and never
+// ships more than a cell holds since the flux can't.
+template <int W> void PipeTransport(PipeGrid &g, const PipeParams &p, int i) {
+  int s = g.stride;
+  auto concentration = [&](int j) {
+    Float<W> water = Load<W>(g.water, j);
+    return Select(water > Float<W>(MinWaterDepth),
+                  Load<W>(g.sediment, j) / water, Float<W>(0.0f));
+  };
+  Float<W> in = Load<W>(g.fluxR, i - 1) * concentration(i - 1) +
+                Load<W>(g.fluxL, i + 1) * concentration(i + 1) +
+                Load<W>(g.fluxB, i - s) * concentration(i - s) +
+                Load<W>(g.fluxT, i + s) * concentration(i + s);
+  Float<W> out = (Load<W>(g.fluxL, i) + Load<W>(g.fluxR, i) +
+                  Load<W>(g.fluxT, i) + Load<W>(g.fluxB, i)) *
+                 concentration(i);
+  Float<W> next = Load<W>(g.sediment, i) + Float<W>(p.dt) * (in - out);
+  Max(next, Float<W>(0.0f)).Store(g.sedimentNext.data() + i);
+}
+
+// 3. New water height from the fluxes (plus rain), the velocity through the
+// cell, and the sediment capacity of the moving water
+template <int W> void PipeWater(PipeGrid &g, const PipeParams &p, int i) {
+  int s = g.stride;
+  Float<W> l = Load<W>(g.fluxL, i);
+  Float<W> r = Load<W>(g.fluxR, i);
+  Float<W> t = Load<W>(g.fluxT, i);
+  Float<W> b = Load<W>(g.fluxB, i);
+  Float<W> inL = Load<W>(g.fluxR, i - 1);
+  Float<W> inR = Load<W>(g.fluxL, i + 1);
+  Float<W> inT = Load<W>(g.fluxB, i - s);
+  Float<W> inB = Load<W>(g.fluxT, i + s);
+
+  Float<W> zero(0.0f);
+  Float<W> half(0.5f);
+  Float<W> before = Load<W>(g.water, i);
+  Float<W> net = inL + inR + inT + inB - l - r - t - b + Float<W>(p.rain);
+  Float<W> after = Max(zero, before + Float<W>(p.dt) * net);
+  after.Store(g.water.data() + i);
+
+  Float<W> mean = (before + after) * half;
+  Float<W> wet = mean > Float<W>(MinWaterDepth);
+  Float<W> u = Select(wet, (inL - l + r - inR) * half / mean, zero);
+  Float<W> v = Select(wet, (inT - t + b - inB) * half / mean, zero);
+
+  // sin of the local tilt from the central-difference gradient
+  Float<W> gx = (Load<W>(g.height, i + 1) - Load<W>(g.height, i - 1)) * half;
+  Float<W> gz = (Load<W>(g.height, i + s) - Load<W>(g.height, i - s)) * half;
+  Float<W> slope = gx * gx + gz * gz;
+  Float<W> tilt = Sqrt(slope / (Float<W>(1.0f) + slope));
+
+  // Scaled by the water depth so thin films can't carry (and dig) much, like
+  // the droplets' capacity scales with their water
+  Float<W> capacity = Float<W>(p.capacity) * Max(tilt, Float<W>(p.minTilt)) *
+                      Sqrt(u * u + v * v) * after;
+  capacity.Store(g.capacity.data() + i);
+}
+
+// 4. Dissolve or deposit towards the capacity, then evaporate. Returns the
+// height change.
+template <int W> Float<W> PipeErode(PipeGrid &g, const PipeParams &p, int i) {
+  Float<W> sediment = Load<W>(g.sediment, i);
+  Float<W> excess = Load<W>(g.capacity, i) - sediment;
+  // Positive dissolves, negative deposits
+  Float<W> rate = Select(excess > Float<W>(0.0f), Float<W>(p.dissolve),
+                         Float<W>(p.deposit));
+  Float<W> amount = rate * Float<W>(p.dt) * excess;
+  (Load<W>(g.height, i) - amount).Store(g.height.data() + i);
+  (sediment + amount).Store(g.sediment.data() + i);
+  (Load<W>(g.water, i) * Float<W>(1.0f - p.evaporation * p.dt))
+      .Store(g.water.data() + i);
+  return Abs(amount);
+}
+
+} // namespace
+
+bool ErosionGenerator::RunGrid(Data::Terrain *terrain, const Config &config,
+                               Core::JobProgress *progress) {
+  PipeGrid grid;
+  grid.width = terrain->width;
+  grid.depth = terrain->depth;
+  grid.stride = grid.width + 2;
+  size_t cells = (size_t)grid.stride * (grid.depth + 2);
+  for (auto *layer :
+       {&grid.height, &grid.water, &grid.sediment, &grid.sedimentNext,
+        &grid.capacity, &grid.fluxL, &grid.fluxR, &grid.fluxT, &grid.fluxB})
+    layer->assign(cells, 0.0f);
+  grid.rowChange.assign(grid.depth, 0.0f);
+
+  // Terrain heights with the edges repeated into the border
+  for (int z = 0; z < grid.depth + 2; z++) {
+    int sz = std::clamp(z - 1, 0, grid.depth - 1);
+    for (int x = 0; x < grid.width + 2; x++) {
+      int sx = std::clamp(x - 1, 0, grid.width - 1);
+      grid.height[z * grid.stride + x] =
+          terrain->heightMap[sz * grid.width + sx];
+    }
+  }
+
+  PipeParams params;
+  params.dt = config.timeStep;
+  params.gravity = config.gravity;
+  params.rain = config.rainRate;
+  params.evaporation = config.evaporationRate;
+  params.capacity = config.capacityFactor;
+  params.minTilt = config.minSlope;
+  params.dissolve = config.erosionRate;
+  params.deposit = config.depositionRate;
+
+  // Water only settles to its rain/evaporation balance after about
+  // 1 / (evaporation * dt) steps, so convergence isn't checked before that
+  int warmup = 0;
+  if (config.evaporationRate > 0.0f && config.timeStep > 0.0f)
+    warmup = (int)std::ceil(1.0f / (config.evaporationRate * config.timeStep));
+
+  GENESIS_PROFILE_SCOPE("Erosion/Grid");
+  for (int step = 0; step < config.gridSteps; step++) {
+    if (progress) {
+      if (progress->IsCancelled())
+        return false;
+      progress->Set((float)step / config.gridSteps);
+    }
+
+    // Each pass only writes its own cells and reads what earlier passes
+    // finished, so rows can run in any order
+    ForEachCell(grid, [&](auto lanes, int i, int) {
+      PipeFlux<decltype(lanes)::value>(grid, params, i);
+    });
+    ForEachCell(grid, [&](auto lanes, int i, int) {
+      PipeTransport<decltype(lanes)::value>(grid, params, i);
+    });
+    ForEachCell(grid, [&](auto lanes, int i, int) {
+      PipeWater<decltype(lanes)::value>(grid, params, i);
+    });
+    std::swap(grid.sediment, grid.sedimentNext);
+
+    std::fill(grid.rowChange.begin(), grid.rowChange.end(), 0.0f);
+    ForEachCell(grid, [&](auto lanes, int i, int z) {
+      constexpr int W = decltype(lanes)::value;
+      float change = HorizontalMax<W>(PipeErode<W>(grid, params, i));
+      grid.rowChange[z] = std::max(grid.rowChange[z], change);
+    });
+
+    float change =
+        *std::max_element(grid.rowChange.begin(), grid.rowChange.end());
+    if (config.convergence > 0.0f && step >= warmup &&
+        change < config.convergence)
+      break;
   }
 
-  // Rebuild mesh after erosion
-  TerrainGenerator::RebuildMesh(terrain, terrainConfig);
+  // Whatever is still suspended settles where it is
+  for (int z = 0; z < grid.depth; z++) {
+    for (int x = 0; x < grid.width; x++) {
+      int i = (z + 1) * grid.stride + x + 1;
+      terrain->heightMap[z * grid.width + x] =
+          grid.height[i] + grid.sediment[i];
+    }
+  }
+  terrain->MarkAllDirty();
+  return true;
 }
 
-void ErosionGenerator::GetGradient(Data::Terrain *terrain, float x, float z,
-                                   float &gx, float &gz) {
-  int nodeX = (int)x;
-  int nodeZ = (int)z;
-  float u = x - nodeX;
-  float v = z - nodeZ;
+std::shared_ptr<const ErosionGenerator::Brush>
+ErosionGenerator::GetBrush(int width, int depth, int radius) {
+  // Repeated runs (and every droplet of a run) share the last brush
+  static std::mutex cacheMutex;
+  static std::shared_ptr<const Brush> cached;
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  if (cached && cached->width == width && cached->depth == depth &&
+      cached->radius == radius)
+    return cached;
 
-  // Get heights of 4 neighbors
-  // Indices must be safe due to loop bounds
-  int w = terrain->width;
-  float h00 = terrain->heightMap[nodeZ * w + nodeX];
-  float h10 = terrain->heightMap[nodeZ * w + (nodeX + 1)];
-  float h01 = terrain->heightMap[(nodeZ + 1) * w + nodeX];
-  float h11 = terrain->heightMap[(nodeZ + 1) * w + (nodeX + 1)];
+  auto brush = std::make_shared<Brush>();
+  brush->width = width;
+  brush->depth = depth;
+  brush->radius = radius;
+
+  // Collects the taps of the disc around (x, z) that fall inside the grid
+  auto addTaps = [&](int x, int z, int base, std::vector<int> &indices,
+                     std::vector<float> &weights) {
+    size_t first = weights.size();
+    float sum = 0.0f;
+    for (int dz = -radius; dz <= radius; dz++) {
+      for (int dx = -radius; dx <= radius; dx++) {
+        float distance = std::sqrt((float)(dx * dx + dz * dz));
+        if (distance >= (float)radius || x + dx < 0 || x + dx >= width ||
+            z + dz < 0 || z + dz >= depth)
+          continue;
+        float weight = 1.0f - distance / radius;
+        indices.push_back((z + dz) * width + (x + dx) - base);
+        weights.push_back(weight);
+        sum += weight;
+      }
+    }
+    for (size_t i = first; i < weights.size(); i++)
+      weights[i] /= sum;
+  };
 
-  // Bilinear gradient approximation
-  gx = (h10 - h00) * (1 - v) + (h11 - h01) * v;
-  gz = (h01 - h00) * (1 - u) + (h11 - h10) * u;
+  // The interior kernel, as offsets from the centre cell
+  addTaps(radius, radius, radius * width + radius, brush->offsets,
+          brush->weights);
+
+  // Edge cells in slot order (see GetBorderSlot)
+  brush->borderStart.push_back(0);
+  for (int z = 0; z < depth; z++) {
+    for (int x = 0; x < width; x++) {
+      if (brush->GetBorderSlot(x, z) < 0)
+        continue;
+      addTaps(x, z, 0, brush->borderIndices, brush->borderWeights);
+      brush->borderStart.push_back((int)brush->borderIndices.size());
+    }
+  }
+
+  cached = brush;
+  return cached;
 }
 
-float ErosionGenerator::GetHeightInterpolated(Data::Terrain *terrain, float x,
-                                              float z) {
-  int nodeX = (int)x;
-  int nodeZ = (int)z;
-  float u = x - nodeX;
-  float v = z - nodeZ;
+int ErosionGenerator::Brush::Get(int x, int z, int &base,
+                                 const int *&outIndices,
+                                 const float *&outWeights) const {
+  int slot = GetBorderSlot(x, z);
+  if (slot < 0) {
+    base = z * width + x;
+    outIndices = offsets.data();
+    outWeights = weights.data();
+    return (int)offsets.size();
+  }
+  int start = borderStart[slot];
+  base = 0;
+  outIndices = borderIndices.data() + start;
+  outWeights = borderWeights.data() + start;
+  return borderStart[slot + 1] - start;
+}
 
-  int w = terrain->width;
-  float h00 = terrain->heightMap[nodeZ * w + nodeX];
-  float h10 = terrain->heightMap[nodeZ * w + (nodeX + 1)];
-  float h01 = terrain->heightMap[(nodeZ + 1) * w + nodeX];
-  float h11 = terrain->heightMap[(nodeZ + 1) * w + (nodeX + 1)];
+int ErosionGenerator::Brush::GetBorderSlot(int x, int z) const {
+  // Grids too small for an interior treat every cell as an edge cell
+  if (width <= 2 * radius || depth <= 2 * radius)
+    return z * width + x;
 
-  return (h00 * (1 - u) * (1 - v)) + (h10 * u * (1 - v)) + (h01 * (1 - u) * v) +
-         (h11 * u * v);
+  // Slots run row by row: `radius` full rows, then 2 * radius cells (left
+  // and right strips) per middle row, then `radius` full rows
+  int middleRows = depth - 2 * radius;
+  if (z < radius)
+    return z * width + x;
+  if (z >= depth - radius)
+    return radius * width + middleRows * 2 * radius +
+           (z - (depth - radius)) * width + x;
+  int row = radius * width + (z - radius) * 2 * radius;
+  if (x < radius)
+    return row + x;
+  if (x >= width - radius)
+    return row + radius + (x - (width - radius));
+  return -1;
 }
 
 } // namespace Genesis::Generator
@@ -1,44 +1,179 @@
 #pragma once
 
+#include "../Core/Job.h"
+#include "../Core/Random.h"
 #include "../Data/World.h"
 #include "TerrainGenerator.h"
+#include <memory>
+#include <vector>
 
 namespace Genesis::Generator {
 
 class ErosionGenerator {
 public:
+  enum class Method {
+    Droplets, // Particles tracing down the slope, one at a time per tile
+    Grid,     // Pipe-model shallow water solver over the whole grid
+  };
+
   struct Config {
+    Method method = Method::Droplets;
+
     int iterations = 50000;
     float erosionRate = 0.5f;
     float depositionRate = 0.5f;
     float gravity = 4.0f;
     float evaporationRate = 0.05f;
-    int erosionRadius = 3;
+    int erosionRadius = 3; // Erosion brush radius; 0 = the 4 bilinear nodes
     float maxLifetime = 30; // Max steps per droplet
     float inertia = 0.05f;  // How much previous direction affects movement
     float startSpeed = 1.0f;
     float startWater = 1.0f;
     float minSlope = 0.05f;
     float capacityFactor = 4.0f; // Multiplier for sediment capacity
+    int seed = 12345;            // Droplet spawn positions
+    bool parallel = true;        // Spread tiles across the thread pool
+
+    // Grid method. Also uses gravity, erosionRate (dissolving),
+    // depositionRate, evaporationRate, capacityFactor and minSlope (minimum
+    // tilt) from above, per unit of time.
+    int gridSteps = 400;
+    float timeStep = 0.05f;
+    float rainRate = 0.002f;    // Water added to every cell per unit of time
+    float convergence = 0.0f;   // Stop when no cell moves more (0 = all steps)
   };
 
+  // Droplets are scheduled in tiles so they can run in parallel: each round
+  // spawns a batch of droplets, buckets them by start tile, and runs the
+  // tiles in 4 phases (2x2 colouring). Tiles are at least twice a droplet's
+  // reach, so tiles of one phase never touch the same cells, and each tile
+  // runs its droplets in spawn order, BatchSize at a time in lockstep (see
+  // SimulateBatch). The result only depends on the seed, not on the thread
+  // count or on `parallel`.
+  //
+  // The grid method (Mei et al., "Fast Hydraulic Erosion Simulation and
+  // Visualization on GPU") keeps water height, outflow flux, velocity and
+  // suspended sediment per cell and updates every cell each step, in SIMD
+  // row kernels spread over the thread pool. Memory is a fixed set of float
+  // layers. It runs gridSteps steps, or stops early once the largest height
+  // change per step drops below `convergence`.
+  //
+  // `progress` (optional) receives the fraction of droplets (or steps)
+  // simulated and stops the run early when cancelled
   static void Execute(Data::World &world, const Config &config,
-                      const TerrainGenerator::Config &terrainConfig);
+                      const TerrainGenerator::Config &terrainConfig,
+                      Core::JobProgress *progress = nullptr);
 
 private:
-  struct Droplet {
+  // Snapshots the heightmap before the first run and restores it before
+  // later ones
+  static void PrepareRun(Data::Terrain *terrain);
+  // Returns false when cancelled
+  static bool RunGrid(Data::Terrain *terrain, const Config &config,
+                      Core::JobProgress *progress);
+
+  struct Spawn {
     float x, z;
-    float dirX, dirZ;
-    float speed;
-    float water;
-    float sediment;
   };
 
-  // Helper to get gradient at position
-  static void GetGradient(Data::Terrain *terrain, float x, float z, float &gx,
-                          float &gz);
+  // Erosion weights around every cell for one grid size and radius (cells
+  // closer than `radius`, weight 1 - distance / radius, summing to 1).
+  // Interior cells all share one kernel of index offsets; cells within
+  // `radius` of the edge are clipped, so each gets its own renormalised
+  // entries with absolute indices (CSR: borderStart[slot]..[slot + 1]).
+  struct Brush {
+    int width = 0;
+    int depth = 0;
+    int radius = 0;
+
+    std::vector<int> offsets;
+    std::vector<float> weights;
+
+    std::vector<int> borderStart;
+    std::vector<int> borderIndices;
+    std::vector<float> borderWeights;
+
+    // Taps for cell (x, z): heightMap[base + outIndices[i]] gets
+    // outWeights[i]. Returns the tap count.
+    int Get(int x, int z, int &base, const int *&outIndices,
+            const float *&outWeights) const;
+
+    // Position of an edge cell in borderStart; -1 for interior cells
+    int GetBorderSlot(int x, int z) const;
+  };
+
+  // Builds (or reuses the last) brush for the grid size and radius
+  static std::shared_ptr<const Brush> GetBrush(int width, int depth,
+                                               int radius);
+
+  // Runs up to BatchSize droplets from `spawns` in lockstep to the end of
+  // their lives, growing `touched` by the cells they wrote. Each step
+  // samples and moves every live droplet (SIMD across droplets), then
+  // applies their erosion/deposition one droplet at a time in batch order.
+  // Without a brush, erosion uses the 4 bilinear nodes like deposition.
+  static void SimulateBatch(Data::Terrain *terrain, const Config &config,
+                            const Brush *brush, const Spawn *spawns,
+                            int count, Data::GridRegion &touched);
+
+  // Smallest tile side (cells); larger lifetimes widen the tiles
+  static constexpr int MinTileSize = 64;
+  // Droplets spawned per round. Rounds interleave the tiles so one tile's
+  // droplets don't all run back to back.
+  static constexpr int RoundSize = 8192;
+  // Droplets simulated in lockstep. Fixed rather than the SIMD width, so
+  // the schedule doesn't depend on the instruction set.
+  static constexpr int BatchSize = 8;
+
+public:
+  // Droplet erosion run a slice at a time, e.g. a few thousand droplets per
+  // frame so viewers can watch the terrain change. Starting a session
+  // restores/snapshots the heightmap like Execute; after that every Step
+  // carries on from the current heights, and Continue sets a new droplet
+  // target to keep eroding past config.iterations without starting over.
+  // Each Step runs whole rounds (cut short at the step's budget), so the
+  // result depends on the seed and the step sizes: steps that are multiples
+  // of RoundSize (8192) match Execute exactly. Not thread-safe; the terrain
+  // must not be read elsewhere while Step runs.
+  class Session {
+  public:
+    Session(std::shared_ptr<Data::Terrain> terrain, const Config &config);
+
+    // Runs up to maxDroplets more droplets (fewer when the target is
+    // reached) and marks the cells they changed dirty. Returns the count.
+    int Step(int maxDroplets);
+    // Steps whole rounds up to the target. Returns false when cancelled.
+    bool Run(Core::JobProgress *progress = nullptr);
+    // Sets the target to `droplets` past the ones run so far
+    void Continue(int droplets);
+
+    int GetDone() const { return done; }
+    int GetTarget() const { return target; }
+    bool IsFinished() const { return done >= target; }
+    const std::shared_ptr<Data::Terrain> &GetTerrain() const {
+      return terrain;
+    }
+
+  private:
+    // Spawns `count` droplets and runs them tile by tile (see Execute)
+    void RunRound(int count);
 
-  static float GetHeightInterpolated(Data::Terrain *terrain, float x, float z);
+    std::shared_ptr<Data::Terrain> terrain;
+    Config config;
+    std::shared_ptr<const Brush> brush;
+    int tileSize = MinTileSize;
+    int tilesX = 0;
+    int tilesZ = 0;
+    Core::Random random;
+    int done = 0;
+    int target = 0;
+
+    std::vector<Spawn> spawns;
+    std::vector<Spawn> bucketed;
+    std::vector<int> tileStart;
+    std::vector<int> phaseTiles;
+    // Bounds of the cells droplets wrote to this step, one per tile
+    std::vector<Data::GridRegion> touched;
+  };
 };
 
 } // namespace Genesis::Generator
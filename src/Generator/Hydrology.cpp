@@ -0,0 +1,263 @@
+#include "Hydrology.h"
+#include "../Core/Profiler.h"
+#include "../Core/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <queue>
+
+namespace Genesis::Generator {
+
+void Hydrology::FlowDirections(const Data::Terrain &terrain,
+                               std::vector<int32_t> &downstream) {
+  GENESIS_PROFILE_SCOPE("Hydrology/FlowDirections");
+  int width = terrain.width;
+  int depth = terrain.depth;
+  const float *heights = terrain.heightMap.data();
+  downstream.assign((size_t)width * depth, -1);
+
+  const float diagonal = 1.0f / std::sqrt(2.0f);
+  int blocks = (depth + BlockRows - 1) / BlockRows;
+  Core::ThreadPool::Get().ParallelFor(blocks, [&](int block) {
+    int z0 = block * BlockRows;
+    int z1 = std::min(z0 + BlockRows, depth);
+    for (int z = z0; z < z1; z++) {
+      for (int x = 0; x < width; x++) {
+        int i = z * width + x;
+        float h = heights[i];
+        float steepest = 0.0f;
+        int target = -1;
+        for (int dz = -1; dz <= 1; dz++) {
+          int nz = z + dz;
+          if (nz < 0 || nz >= depth)
+            continue;
+          for (int dx = -1; dx <= 1; dx++) {
+            int nx = x + dx;
+            if ((dx == 0 && dz == 0) || nx < 0 || nx >= width)
+              continue;
+            int n = nz * width + nx;
+            float slope = h - heights[n];
+            if (dx != 0 && dz != 0)
+              slope *= diagonal;
+            // Strictly downhill, so the flow graph has no cycles
+            if (slope > steepest) {
+              steepest = slope;
+              target = n;
+            }
+          }
+        }
+        downstream[i] = target;
+      }
+    }
+  });
+}
+
+void Hydrology::FlowAccumulation(const std::vector<int32_t> &downstream,
+                                 std::vector<int32_t> &accumulation) {
+  GENESIS_PROFILE_SCOPE("Hydrology/FlowAccumulation");
+  int cells = (int)downstream.size();
+  accumulation.assign(cells, 1);
+
+  // Cells draining into each cell
+  std::vector<int32_t> donors(cells, 0);
+  int blockSize = BlockRows * 256;
+  int blocks = (cells + blockSize - 1) / blockSize;
+  auto forEachBlock = [&](auto &&fn) {
+    Core::ThreadPool::Get().ParallelFor(blocks, [&](int block) {
+      int begin = block * blockSize;
+      fn(begin, std::min(begin + blockSize, cells));
+    });
+  };
+  forEachBlock([&](int begin, int end) {
+    for (int i = begin; i < end; i++)
+      if (downstream[i] >= 0)
+        std::atomic_ref<int32_t>(donors[downstream[i]])
+            .fetch_add(1, std::memory_order_relaxed);
+  });
+
+  // Every walk starts at a cell nothing drains into and carries its total
+  // downstream. Whoever delivers the last donor's total to a cell carries on
+  // from there, so each cell is passed on exactly once, after it's complete.
+  std::vector<int32_t> pending = donors;
+  forEachBlock([&](int begin, int end) {
+    for (int start = begin; start < end; start++) {
+      if (donors[start] != 0)
+        continue;
+      int cell = start;
+      int32_t total = accumulation[cell];
+      for (int next = downstream[cell]; next >= 0; next = downstream[cell]) {
+        std::atomic_ref<int32_t> sum(accumulation[next]);
+        sum.fetch_add(total, std::memory_order_relaxed);
+        if (std::atomic_ref<int32_t>(pending[next])
+                .fetch_sub(1, std::memory_order_acq_rel) != 1)
+          break;
+        cell = next;
+        total = sum.load(std::memory_order_relaxed);
+      }
+    }
+  });
+}
+
+void Hydrology::FillDepressions(const Data::Terrain &terrain,
+                                std::vector<float> &filled,
+                                std::vector<int32_t> &floodParent) {
+  GENESIS_PROFILE_SCOPE("Hydrology/FillDepressions");
+  int width = terrain.width;
+  int depth = terrain.depth;
+  int cells = width * depth;
+  const float *heights = terrain.heightMap.data();
+  filled.assign(heights, heights + cells);
+  floodParent.assign(cells, -1);
+  Data::BitLayer closed;
+  closed.Assign(width, depth);
+
+  // Lowest level first; ties by index so the flood order (and with it
+  // floodParent) is deterministic
+  struct Open {
+    float level;
+    int32_t cell;
+    bool operator>(const Open &other) const {
+      return level > other.level ||
+             (level == other.level && cell > other.cell);
+    }
+  };
+  std::priority_queue<Open, std::vector<Open>, std::greater<Open>> open;
+  std::queue<int32_t> pit;
+
+  for (int z = 0; z < depth; z++) {
+    for (int x = 0; x < width; x++) {
+      if (x != 0 && z != 0 && x != width - 1 && z != depth - 1)
+        continue;
+      int i = z * width + x;
+      closed.Set(x, z);
+      open.push({filled[i], i});
+    }
+  }
+
+  while (!open.empty() || !pit.empty()) {
+    int cell;
+    if (!pit.empty()) {
+      cell = pit.front();
+      pit.pop();
+    } else {
+      cell = open.top().cell;
+      open.pop();
+    }
+
+    int x = cell % width;
+    int z = cell / width;
+    float level = filled[cell];
+    for (int dz = -1; dz <= 1; dz++) {
+      int nz = z + dz;
+      if (nz < 0 || nz >= depth)
+        continue;
+      for (int dx = -1; dx <= 1; dx++) {
+        int nx = x + dx;
+        if (nx < 0 || nx >= width)
+          continue;
+        if (closed.Test(nx, nz))
+          continue;
+        closed.Set(nx, nz);
+        int n = nz * width + nx;
+        floodParent[n] = cell;
+        if (filled[n] <= level) {
+          filled[n] = level;
+          pit.push(n);
+        } else {
+          open.push({filled[n], n});
+        }
+      }
+    }
+  }
+}
+
+void Hydrology::RouteThroughDepressions(
+    const std::vector<float> &filled, const std::vector<int32_t> &floodParent,
+    std::vector<int32_t> &downstream) {
+  GENESIS_PROFILE_SCOPE("Hydrology/RouteThroughDepressions");
+  int cells = (int)downstream.size();
+  int blockSize = BlockRows * 256;
+  int blocks = (cells + blockSize - 1) / blockSize;
+  Core::ThreadPool::Get().ParallelFor(blocks, [&](int block) {
+    int begin = block * blockSize;
+    int end = std::min(begin + blockSize, cells);
+    for (int i = begin; i < end; i++) {
+      int target = downstream[i];
+      if (target < 0 || filled[target] >= filled[i])
+        downstream[i] = floodParent[i];
+    }
+  });
+}
+
+void Hydrology::FindLakes(const Data::Terrain &terrain,
+                          const std::vector<float> &filled,
+                          const std::vector<int32_t> &floodParent,
+                          float seaLevel, int minCells,
+                          Data::GridLayer<uint16_t> &labels,
+                          std::vector<Data::Lake> &lakes) {
+  GENESIS_PROFILE_SCOPE("Hydrology/FindLakes");
+  int width = terrain.width;
+  int depth = terrain.depth;
+  int cells = width * depth;
+  const float *heights = terrain.heightMap.data();
+  labels.Assign(width, depth, 0);
+  lakes.clear();
+
+  // Neighbouring flooded cells always share a level (otherwise the higher
+  // one could drain into the lower), so a flood fill over flooded cells
+  // finds exactly one lake
+  auto flooded = [&](int i) { return filled[i] > heights[i]; };
+  std::vector<int32_t> members;
+  Data::BitLayer seen;
+  seen.Assign(width, depth);
+  for (int start = 0; start < cells; start++) {
+    if (!flooded(start) || seen.Test(start % width, start / width))
+      continue;
+    if ((int)lakes.size() == MaxLakes)
+      break;
+
+    members.clear();
+    members.push_back(start);
+    seen.Set(start % width, start / width);
+    for (size_t m = 0; m < members.size(); m++) {
+      int x = members[m] % width;
+      int z = members[m] / width;
+      for (int dz = -1; dz <= 1; dz++) {
+        for (int dx = -1; dx <= 1; dx++) {
+          int nx = x + dx;
+          int nz = z + dz;
+          if (nx < 0 || nx >= width || nz < 0 || nz >= depth)
+            continue;
+          int n = nz * width + nx;
+          if (flooded(n) && !seen.Test(nx, nz)) {
+            seen.Set(nx, nz);
+            members.push_back(n);
+          }
+        }
+      }
+    }
+
+    float level = filled[start];
+    if (level < seaLevel || (int)members.size() < minCells)
+      continue;
+
+    // The flood reached the lake from its spill point, so following any
+    // lake cell's flood parents leads out over it
+    int spill = start;
+    while (spill >= 0 && flooded(spill))
+      spill = floodParent[spill];
+    if (spill < 0)
+      spill = start;
+
+    Data::Lake lake;
+    lake.level = level;
+    lake.spillX = spill % width;
+    lake.spillZ = spill / width;
+    lake.cells = (int)members.size();
+    lakes.push_back(lake);
+    for (int32_t cell : members)
+      labels[cell] = (uint16_t)lakes.size();
+  }
+}
+
+} // namespace Genesis::Generator
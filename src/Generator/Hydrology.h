@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../Data/Terrain.h"
+#include <cstdint>
+#include <vector>
+
+namespace Genesis::Generator {
+
+// Grid hydrology on the heightmap: where water on each cell goes, how much
+// of the map drains through it, and where it pools. FlowDirections,
+// RouteThroughDepressions and FlowAccumulation are O(cells) and spread over
+// the thread pool. FillDepressions (a heap flood, O(cells log cells)) and
+// FindLakes (a flood fill, O(cells)) run single-threaded.
+class Hydrology {
+public:
+  // Cell index each cell drains to (D8: the neighbour with the steepest drop,
+  // diagonals a sqrt(2) step away), or -1 for pits and cells whose only lower
+  // ground is off the map.
+  static void FlowDirections(const Data::Terrain &terrain,
+                             std::vector<int32_t> &downstream);
+
+  // Number of cells (the cell itself included) whose flow passes through each
+  // cell, following `downstream`. Integer counts, so the result is exact and
+  // doesn't depend on the order threads add them up in.
+  static void FlowAccumulation(const std::vector<int32_t> &downstream,
+                               std::vector<int32_t> &accumulation);
+
+  // Priority-flood (Barnes et al. 2014, "Priority-Flood: An Optimal
+  // Depression-Filling and Watershed-Labeling Algorithm", improved variant):
+  // floods inwards from the map edge in order of height, raising every cell
+  // to the lowest level at which its water can reach the edge. `filled` is
+  // that water surface; `floodParent` is the neighbour each cell was reached
+  // from (-1 on the edge), i.e. the way out of its depression. Cells at or
+  // below the current level go through a FIFO instead of the heap, so
+  // depressions and flats cost O(1) per cell.
+  static void FillDepressions(const Data::Terrain &terrain,
+                              std::vector<float> &filled,
+                              std::vector<int32_t> &floodParent);
+
+  // Lets flow cross depressions: cells without a downhill D8 neighbour on
+  // the filled surface (pits, flats and lake cells) follow floodParent
+  // instead, so all flow reaches the map edge through the spill points.
+  // D8 steps strictly lower the surface and flood steps go to cells flooded
+  // earlier, so the result stays cycle-free.
+  static void RouteThroughDepressions(const std::vector<float> &filled,
+                                      const std::vector<int32_t> &floodParent,
+                                      std::vector<int32_t> &downstream);
+
+  // Labels each connected area the flood raised above the ground as a lake
+  // (0 = none, else 1 + index into lakes), with its level and the rim cell
+  // it spills over. Depressions that fill below seaLevel belong to the sea
+  // and ones smaller than minCells are skipped, as is anything past the
+  // first MaxLakes lakes.
+  static void FindLakes(const Data::Terrain &terrain,
+                        const std::vector<float> &filled,
+                        const std::vector<int32_t> &floodParent,
+                        float seaLevel, int minCells,
+                        Data::GridLayer<uint16_t> &labels,
+                        std::vector<Data::Lake> &lakes);
+
+  static constexpr int MaxLakes = 65535;
+
+private:
+  // Rows of the grid per parallel task
+  static constexpr int BlockRows = 32;
+};
+
+} // namespace Genesis::Generator
@@ -0,0 +1,121 @@
+#include "Noise.h"
+#include "../Core/Simd.h"
+#include <cstdint>
+
+namespace Genesis::Generator {
+
+using namespace Genesis::Core::Simd;
+
+namespace {
+
+// Scales the raw lattice interpolation to roughly [-1, 1]
+constexpr float PerlinScale = 1.25f;
+
+// Per-octave seed offset so octaves don't line up with each other
+constexpr uint32_t OctaveSeedStep = 0x9E3779B9u;
+
+constexpr int32_t HashPrimeX = 0x27d4eb2d;
+constexpr int32_t HashPrimeZ = 0x165667b1;
+
+template <int W> Int<W> Hash(Int<W> hx, Int<W> hz, Int<W> seed) {
+  Int<W> h = seed ^ hx ^ hz;
+  h = h * Int<W>(0x2c1b3c6d);
+  h = h ^ (h >> 15);
+  h = h * Int<W>(0x297a2d39);
+  h = h ^ (h >> 13);
+  return h;
+}
+
+// Dot product with one of 8 gradients (+-1, +-0.5) / (+-0.5, +-1), picked
+// from the low three hash bits. Sign flips are done on the float sign bit so
+// every lane stays branch free.
+template <int W> Float<W> Grad(Int<W> h, Float<W> x, Float<W> z) {
+  Float<W> swap = (h & Int<W>(4)) == Int<W>(4);
+  Float<W> u = Select(swap, z, x);
+  Float<W> v = Select(swap, x, z) * Float<W>(0.5f);
+  u = AsFloat(AsInt(u) ^ (h << 31));
+  v = AsFloat(AsInt(v) ^ ((h & Int<W>(2)) << 30));
+  return u + v;
+}
+
+template <int W> Float<W> Fade(Float<W> t) {
+  return t * t * t * (t * (t * Float<W>(6.0f) - Float<W>(15.0f)) +
+                      Float<W>(10.0f));
+}
+
+template <int W> Float<W> PerlinImpl(Float<W> x, Float<W> z, Int<W> seed) {
+  Float<W> x0 = Floor(x);
+  Float<W> z0 = Floor(z);
+  Float<W> fx = x - x0;
+  Float<W> fz = z - z0;
+
+  Int<W> hx0 = ToInt(x0) * Int<W>(HashPrimeX);
+  Int<W> hz0 = ToInt(z0) * Int<W>(HashPrimeZ);
+  Int<W> hx1 = hx0 + Int<W>(HashPrimeX);
+  Int<W> hz1 = hz0 + Int<W>(HashPrimeZ);
+
+  Float<W> one(1.0f);
+  Float<W> n00 = Grad(Hash(hx0, hz0, seed), fx, fz);
+  Float<W> n10 = Grad(Hash(hx1, hz0, seed), fx - one, fz);
+  Float<W> n01 = Grad(Hash(hx0, hz1, seed), fx, fz - one);
+  Float<W> n11 = Grad(Hash(hx1, hz1, seed), fx - one, fz - one);
+
+  Float<W> u = Fade(fx);
+  Float<W> v = Fade(fz);
+  Float<W> nx0 = n00 + u * (n10 - n00);
+  Float<W> nx1 = n01 + u * (n11 - n01);
+  return (nx0 + v * (nx1 - nx0)) * Float<W>(PerlinScale);
+}
+
+template <int W>
+Float<W> FractalImpl(Float<W> x, Float<W> z,
+                     const Noise::FractalConfig &config) {
+  Float<W> sum(0.0f);
+  float frequency = config.frequency;
+  float amplitude = 1.0f;
+  uint32_t seed = (uint32_t)config.seed;
+
+  for (int o = 0; o < config.octaves; o++) {
+    Float<W> f(frequency);
+    sum = sum + PerlinImpl<W>(x * f, z * f, Int<W>((int32_t)seed)) *
+                    Float<W>(amplitude);
+    frequency *= config.lacunarity;
+    amplitude *= config.gain;
+    seed += OctaveSeedStep;
+  }
+  return sum;
+}
+
+} // namespace
+
+float Noise::Perlin(float x, float y, int seed) {
+  return PerlinImpl<1>(x, y, seed).v;
+}
+
+float Noise::Fractal(int x, int z, const FractalConfig &config) {
+  return FractalImpl<1>((float)x, (float)z, config).v;
+}
+
+void Noise::FractalRow(float *out, int x0, int z, int count,
+                       const FractalConfig &config) {
+  constexpr int W = NativeWidth;
+  int i = 0;
+
+  if constexpr (W > 1) {
+    alignas(32) float laneOffsets[W];
+    for (int l = 0; l < W; l++)
+      laneOffsets[l] = (float)l;
+    Float<W> offsets = Float<W>::Load(laneOffsets);
+    Float<W> zs((float)z);
+
+    for (; i + W <= count; i += W) {
+      Float<W> xs = Float<W>((float)(x0 + i)) + offsets;
+      FractalImpl<W>(xs, zs, config).Store(out + i);
+    }
+  }
+
+  for (; i < count; i++)
+    out[i] = Fractal(x0 + i, z, config);
+}
+
+} // namespace Genesis::Generator
@@ -0,0 +1,34 @@
+#pragma once
+
+namespace Genesis::Generator {
+
+// Float32 gradient noise used to build heightmaps.
+// Gradients are picked from an integer hash of the lattice point instead of a
+// permutation table, so every lane of a SIMD register can be evaluated without
+// table lookups. Sample positions are derived from absolute grid coordinates,
+// so any sub-rectangle of the grid produces exactly the same values as a full
+// pass over it.
+class Noise {
+public:
+  struct FractalConfig {
+    int seed = 0;
+    float frequency = 1.0f; // Noise-space units per grid cell
+    int octaves = 6;
+    float lacunarity = 2.0f; // Frequency multiplier per octave
+    float gain = 0.5f;       // Amplitude multiplier per octave
+  };
+
+  // Single octave 2D Perlin noise, roughly in [-1, 1]
+  static float Perlin(float x, float y, int seed);
+
+  // fBm sum of Perlin octaves at grid cell (x, z). Not normalized, so the range
+  // grows with octaves/gain the same way raylib's fbm did.
+  static float Fractal(int x, int z, const FractalConfig &config);
+
+  // Fills out[0..count) with Fractal(x0 + i, z). Vectorized (AVX2/SSE4.1 when
+  // the build enables them), with a scalar tail using the same math.
+  static void FractalRow(float *out, int x0, int z, int count,
+                         const FractalConfig &config);
+};
+
+} // namespace Genesis::Generator
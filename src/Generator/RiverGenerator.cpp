@@ -1,38 +1,239 @@
 #include "RiverGenerator.h"
-#include "TerrainGenerator.h" // For re-generating mesh if needed (or we can just update colors)
-#include "raymath.h"
+#include "../Core/Profiler.h"
+#include "../Core/Random.h"
+#include "../Core/ThreadPool.h"
+#include "Hydrology.h"
+#include "TerrainGenerator.h"
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <vector>
 
 namespace Genesis::Generator {
 
 void RiverGenerator::Generate(Data::World &world, const Config &config,
-                              const TerrainGenerator::Config &terrainConfig) {
+                              const TerrainGenerator::Config &terrainConfig,
+                              Core::JobProgress *progress) {
+  GENESIS_PROFILE_SCOPE("Rivers/Generate");
   if (!world.terrain)
     return;
   auto terrain = world.terrain.get();
 
   // Restore base heightmap to clear previous erosion
-  if (!terrain->baseHeightMap.empty() &&
-      terrain->baseHeightMap.size() == terrain->heightMap.size()) {
-    terrain->heightMap = terrain->baseHeightMap;
-    // Invalidate erosion snapshot since we reverted to base
-    terrain->preErosionHeightMap.clear();
+  if (terrain->baseHeightMap.Matches(terrain->width, terrain->depth)) {
+    terrain->baseHeightMap.Restore(terrain->heightMap);
+    // Invalidate erosion snapshots since we reverted to base
+    terrain->preErosionHeightMap.Clear();
+    terrain->preThermalHeightMap.Clear();
   }
 
   // Always reset river map before generation
-  terrain->riverMap.assign(terrain->heightMap.size(), 0);
+  terrain->ClearRivers();
+  terrain->MarkAllDirty();
+  auto network = world.riverNetwork.get();
+  network->Clear();
+
+  bool finished = config.method == Method::FlowAccumulation
+                      ? ExtractRivers(terrain, network, config,
+                                      terrainConfig.seaLevel, progress)
+                      : TraceRivers(terrain, config, terrainConfig.seaLevel,
+                                    progress);
+
+  // Viewers rebuild from the dirty cells, using the provided terrain config
+  if (finished)
+    TerrainGenerator::ApplyDisplaySettings(terrain, terrainConfig);
+}
+
+bool RiverGenerator::ExtractRivers(Data::Terrain *terrain,
+                                   Data::RiverNetwork *network,
+                                   const Config &config, float seaLevel,
+                                   Core::JobProgress *progress) {
+  GENESIS_PROFILE_SCOPE("Rivers/Extract");
+  auto step = [&](float done) {
+    if (!progress)
+      return true;
+    progress->Set(done);
+    return !progress->IsCancelled();
+  };
+
+  // Depressions fill up to their spill level, and flow crosses them on the
+  // way to the spill point instead of ending in the pit
+  std::vector<float> filled;
+  std::vector<int32_t> floodParent;
+  std::vector<int32_t> downstream;
+  std::vector<int32_t> accumulation;
+  Hydrology::FillDepressions(*terrain, filled, floodParent);
+  if (!step(0.4f))
+    return false;
+  Hydrology::FlowDirections(*terrain, downstream);
+  Hydrology::RouteThroughDepressions(filled, floodParent, downstream);
+  if (!step(0.6f))
+    return false;
+  Hydrology::FlowAccumulation(downstream, accumulation);
+  Hydrology::FindLakes(*terrain, filled, floodParent, seaLevel,
+                       config.minLakeCells, terrain->lakeMap, terrain->lakes);
+  if (!step(0.9f))
+    return false;
+
+  // Cells draining a big enough catchment carry a river down to the sea.
+  // Sources are river cells no other river (or lake) cell drains into.
+  int width = terrain->width;
+  int depth = terrain->depth;
+  int threshold =
+      std::max(2, (int)(config.minCatchment * (float)width * (float)depth));
+  const uint16_t *lakes = terrain->lakeMap.Data();
+  uint8_t *rivers = terrain->riverMap.Data();
+  auto isRiver = [&](int i) {
+    return accumulation[i] >= threshold && filled[i] >= seaLevel;
+  };
+
+  Core::ThreadPool::Get().ParallelFor(depth, [&](int z) {
+    for (int x = 0; x < width; x++) {
+      int i = z * width + x;
+      if (lakes[i] != 0) {
+        rivers[i] = 3;
+        continue;
+      }
+      if (!isRiver(i))
+        continue;
+      bool source = true;
+      for (int dz = -1; dz <= 1 && source; dz++) {
+        for (int dx = -1; dx <= 1; dx++) {
+          int nx = x + dx;
+          int nz = z + dz;
+          if (nx < 0 || nx >= width || nz < 0 || nz >= depth)
+            continue;
+          int n = nz * width + nx;
+          if (downstream[n] == i && (isRiver(n) || lakes[n] != 0)) {
+            source = false;
+            break;
+          }
+        }
+      }
+      rivers[i] = source ? 1 : 2;
+    }
+  });
+
+  // The network follows the flow through lakes too, so it stays connected
+  std::vector<int32_t> riverCells;
+  for (int i = 0; i < width * depth; i++)
+    if (isRiver(i))
+      riverCells.push_back(i);
+  BuildNetwork(*terrain, riverCells, downstream, accumulation, filled, config,
+               *network);
+  return true;
+}
+
+void RiverGenerator::BuildNetwork(const Data::Terrain &terrain,
+                                  const std::vector<int32_t> &riverCells,
+                                  const std::vector<int32_t> &downstream,
+                                  const std::vector<int32_t> &accumulation,
+                                  const std::vector<float> &filled,
+                                  const Config &config,
+                                  Data::RiverNetwork &network) {
+  GENESIS_PROFILE_SCOPE("Rivers/BuildNetwork");
+  int count = (int)riverCells.size();
+  auto nodeOf = [&](int32_t cell) {
+    auto it = std::lower_bound(riverCells.begin(), riverCells.end(), cell);
+    return it != riverCells.end() && *it == cell
+               ? (int32_t)(it - riverCells.begin())
+               : -1;
+  };
+
+  float scale = terrain.scale;
+  float cellArea = scale * scale;
+  network.nodes.resize(count);
+  for (int n = 0; n < count; n++) {
+    int32_t cell = riverCells[n];
+    auto &node = network.nodes[n];
+    node.position = {(float)(cell % terrain.width) * scale,
+                     (float)(cell / terrain.width) * scale};
+    node.height = filled[cell];
+    node.discharge = (float)accumulation[cell] * cellArea;
+    node.width = config.widthScale * std::sqrt(node.discharge);
+    // Accumulation only grows downstream, so the river never leaves the
+    // river cells until it reaches the sea or the map edge
+    node.downstream = downstream[cell] >= 0 ? nodeOf(downstream[cell]) : -1;
+  }
+  for (const auto &node : network.nodes)
+    if (node.downstream >= 0)
+      network.nodes[node.downstream].upstreamCount++;
+
+  // Segments start at sources and confluences and run until the next one.
+  // Discharge grows downstream, so ordering the starts by it handles every
+  // segment after all the segments flowing into it.
+  std::vector<int32_t> starts;
+  for (int n = 0; n < count; n++)
+    if (network.nodes[n].upstreamCount != 1)
+      starts.push_back(n);
+  std::sort(starts.begin(), starts.end(), [&](int32_t a, int32_t b) {
+    return accumulation[riverCells[a]] < accumulation[riverCells[b]] ||
+           (accumulation[riverCells[a]] == accumulation[riverCells[b]] &&
+            a < b);
+  });
+
+  network.segments.resize(starts.size());
+  for (int s = 0; s < (int)starts.size(); s++)
+    network.nodes[starts[s]].segment = s;
+  // Highest order flowing into each segment, and how many brought it
+  std::vector<int> inOrder(starts.size(), 0);
+  std::vector<int> inOrderCount(starts.size(), 0);
+  for (int s = 0; s < (int)starts.size(); s++) {
+    auto &segment = network.segments[s];
+    int32_t n = starts[s];
+    segment.min = segment.max = network.nodes[n].position;
+    auto include = [&](Core::Vec2 p) {
+      segment.min.x = std::min(segment.min.x, p.x);
+      segment.min.y = std::min(segment.min.y, p.y);
+      segment.max.x = std::max(segment.max.x, p.x);
+      segment.max.y = std::max(segment.max.y, p.y);
+    };
+    for (; n >= 0; n = network.nodes[n].downstream) {
+      auto &node = network.nodes[n];
+      if (node.upstreamCount != 1 && n != starts[s]) {
+        // Confluence: it starts the next segment but ends this one's last edge
+        include(node.position);
+        segment.downstream = node.segment;
+        break;
+      }
+      node.segment = s;
+      segment.nodes.push_back(n);
+      include(node.position);
+    }
 
+    segment.order = inOrderCount[s] == 0   ? 1
+                    : inOrderCount[s] >= 2 ? inOrder[s] + 1
+                                           : inOrder[s];
+    if (segment.downstream >= 0) {
+      int d = segment.downstream;
+      if (segment.order > inOrder[d]) {
+        inOrder[d] = segment.order;
+        inOrderCount[d] = 1;
+      } else if (segment.order == inOrder[d]) {
+        inOrderCount[d]++;
+      }
+    }
+  }
+}
+
+bool RiverGenerator::TraceRivers(Data::Terrain *terrain, const Config &config,
+                                 float seaLevel, Core::JobProgress *progress) {
   // Attempt to spawn rivers
+  Core::Random random(config.seed);
   int riversCreated = 0;
   int attempts = 0;
   int maxAttempts = config.riverCount * 20; // Increase attempts logic
 
   while (riversCreated < config.riverCount && attempts < maxAttempts) {
+    if (progress) {
+      if (progress->IsCancelled())
+        return false;
+      progress->Set((float)attempts / maxAttempts);
+    }
     attempts++;
 
-    int x = GetRandomValue(0, terrain->width - 1);
-    int z = GetRandomValue(0, terrain->depth - 1);
+    int x = random.NextInt(0, terrain->width - 1);
+    int z = random.NextInt(0, terrain->depth - 1);
 
     float h = terrain->GetHeight(x, z);
 
@@ -41,22 +242,19 @@ void RiverGenerator::Generate(Data::World &world, const Config &config,
       // Check if already a river?
       if (terrain->GetRiverType(x, z) == 0) {
         // Trace and check success (length)
-        if (TraceRiver(terrain, x, z, terrainConfig.seaLevel,
-                       config.minRiverLength)) {
+        if (TraceRiver(terrain, x, z, seaLevel, config.minRiverLength)) {
           riversCreated++;
         }
       }
     }
   }
-
-  // After generating data, we update the mesh visuals using the provided
-  // terrain config
-  TerrainGenerator::RebuildMesh(terrain, terrainConfig);
+  return true;
 }
 
 // Return true if river was successfully created (met min length)
 bool RiverGenerator::TraceRiver(Data::Terrain *terrain, int startX, int startZ,
                                 float seaLevel, int minLength) {
+  GENESIS_PROFILE_SCOPE("Rivers/Trace");
   int cx = startX;
   int cz = startZ;
 
@@ -8,18 +8,67 @@ namespace Genesis::Generator {
 
 class RiverGenerator {
 public:
+  enum class Method {
+    FlowAccumulation, // Rivers wherever enough of the map drains through
+    Trace,            // Random high sources traced downhill, carving pits
+  };
+
   struct Config {
+    Method method = Method::FlowAccumulation;
+
+    // Flow accumulation. Share of the map's cells that must drain through a
+    // cell for it to carry a river, so river density doesn't change with
+    // resolution.
+    float minCatchment = 0.002f;
+    int minLakeCells = 16; // Smaller depressions are crossed but not marked
+    // Channel width (world units) per sqrt of catchment area (world units^2),
+    // i.e. width grows with the square root of discharge
+    float widthScale = 0.005f;
+
+    // Trace
     int riverCount = 5;
     int minRiverLength = 10;
     float minSourceHeight = 0.5f; // Only start rivers high up
+    int seed = 1;                 // Picks the source candidates
   };
 
+  // Flow accumulation fills depressions (priority-flood), routes D8 flow
+  // through them to their spill points and accumulates it over the whole
+  // heightmap (see Hydrology). Every cell above sea level whose catchment
+  // reaches minCatchment becomes a river, and depressions of at least
+  // minLakeCells become lakes (Terrain::lakeMap/lakes, riverMap 3). The
+  // heightmap isn't changed. The rivers are also stored as a graph in
+  // World::riverNetwork, continuing through lakes along the flow.
+  //
+  // Trace picks up to riverCount random sources above minSourceHeight and
+  // walks each downhill, carving through pits towards lower ground nearby.
+  // It only marks the river map; the network stays empty.
+  //
+  // `progress` (optional) receives the fraction done and stops the run early
+  // when cancelled
   static void Generate(Data::World &world, const Config &config,
-                       const TerrainGenerator::Config &terrainConfig);
+                       const TerrainGenerator::Config &terrainConfig,
+                       Core::JobProgress *progress = nullptr);
 
 private:
+  // Both return false when cancelled
+  static bool ExtractRivers(Data::Terrain *terrain,
+                            Data::RiverNetwork *network, const Config &config,
+                            float seaLevel, Core::JobProgress *progress);
+  static bool TraceRivers(Data::Terrain *terrain, const Config &config,
+                          float seaLevel, Core::JobProgress *progress);
+
   static bool TraceRiver(Data::Terrain *terrain, int startX, int startZ,
                          float seaLevel, int minLength);
+
+  // Builds the network from the river cells (ascending cell indices) and the
+  // flow graph they were extracted from
+  static void BuildNetwork(const Data::Terrain &terrain,
+                           const std::vector<int32_t> &riverCells,
+                           const std::vector<int32_t> &downstream,
+                           const std::vector<int32_t> &accumulation,
+                           const std::vector<float> &filled,
+                           const Config &config, Data::RiverNetwork &network);
 };
 
 } // namespace Genesis::Generator
@@ -1,90 +1,318 @@
 #include "TensorField.h"
-#include "raymath.h"
+#include "../Core/Profiler.h"
+#include "../Core/Random.h"
+#include "../Core/Simd.h"
+#include "../Core/ThreadPool.h"
+#include "../Data/RiverNetwork.h"
+#include "../Data/Terrain.h"
+#include "Noise.h"
+#include <algorithm>
 #include <cmath>
 
 namespace Genesis::Generator {
 
-TensorField::TensorField(int width, int height)
-    : m_Width(width), m_Height(height) {
-  m_Grid.resize(width * height, {1.0f, 0.0f});
+using namespace Core::Simd;
+
+namespace {
+
+// Rows of the grid per parallel task
+constexpr int BlockRows = 32;
+
+// Gaussian falloff is cut off here (weight below 0.02%)
+constexpr float ReachInRadii = 3.0f;
+
+// Major eigenvector of [a b; b -a] for lanes [0, W): with cos 2t = a / r,
+// the half-angle formulas give cos t and |sin t|, and sin t has b's sign
+template <int W>
+void MajorDirection(Float<W> a, Float<W> b, Float<W> &dirX, Float<W> &dirZ) {
+  Float<W> zero(0.0f);
+  Float<W> half(0.5f);
+  Float<W> one(1.0f);
+  Float<W> r = Sqrt(a * a + b * b);
+  Float<W> c = Select(r > zero, a / r, one);
+  dirX = Sqrt(Max(half * (one + c), zero));
+  Float<W> s = Sqrt(Max(half * (one - c), zero));
+  dirZ = Select(b < zero, zero - s, s);
 }
 
+// Bilinear blend of the grid tensors around each lane's position
+template <int W>
+void SampleLanes(const float *gridA, const float *gridB, int width, int height,
+                 const float *x, const float *z, Float<W> &a, Float<W> &b) {
+  Float<W> zero(0.0f);
+  Float<W> one(1.0f);
+  Float<W> px = Min(Max(Float<W>::Load(x), zero), Float<W>((float)width - 1));
+  Float<W> pz = Min(Max(Float<W>::Load(z), zero), Float<W>((float)height - 1));
+  // The last row/column samples the cell before it at u/v = 1
+  Float<W> cellX = Min(Floor(px), Float<W>((float)width - 2));
+  Float<W> cellZ = Min(Floor(pz), Float<W>((float)height - 2));
+  Float<W> u = px - cellX;
+  Float<W> v = pz - cellZ;
+  Int<W> index = ToInt(cellZ) * Int<W>(width) + ToInt(cellX);
+
+  Float<W> w00 = (one - u) * (one - v);
+  Float<W> w10 = u * (one - v);
+  Float<W> w01 = (one - u) * v;
+  Float<W> w11 = u * v;
+  Int<W> i10 = index + Int<W>(1);
+  Int<W> i01 = index + Int<W>(width);
+  Int<W> i11 = index + Int<W>(width + 1);
+  a = Gather(gridA, index) * w00 + Gather(gridA, i10) * w10 +
+      Gather(gridA, i01) * w01 + Gather(gridA, i11) * w11;
+  b = Gather(gridB, index) * w00 + Gather(gridB, i10) * w10 +
+      Gather(gridB, i01) * w01 + Gather(gridB, i11) * w11;
+}
+
+} // namespace
+
+Tensor Tensor::FromAngle(float angle, float magnitude) {
+  return {magnitude * std::cos(2.0f * angle),
+          magnitude * std::sin(2.0f * angle)};
+}
+
+Core::Vec2 Tensor::GetMajor() const {
+  Float<1> dirX, dirZ;
+  MajorDirection<1>(a, b, dirX, dirZ);
+  return {dirX.v, dirZ.v};
+}
+
+TensorField::TensorField(int width, int height) { Resize(width, height); }
+
 TensorField::~TensorField() {}
 
 void TensorField::Resize(int width, int height) {
-  m_Width = width;
-  m_Height = height;
-  m_Grid.resize(width * height);
+  // Bilinear sampling needs a cell on each axis
+  m_Width = std::max(width, 2);
+  m_Height = std::max(height, 2);
+  m_Dirty = true;
 }
 
 void TensorField::Generate(int seed) {
-  // Use Raylib's Image generation for noise
-  // We generate an image and sample the colors to get noise values 0..1
-  Image noiseImage = GenImagePerlinNoise(m_Width, m_Height, 0, 0, 5.0f);
+  ClearBases();
+  Core::Random random(seed);
+  float width = (float)m_Width;
+  float height = (float)m_Height;
 
-  Color *pixels = LoadImageColors(noiseImage);
+  // A weak grid everywhere keeps the field from degenerating far from the
+  // other bases
+  AddGrid({width * 0.5f, height * 0.5f}, random.NextFloat() * Core::Pi, 0.0f,
+          0.2f);
+  AddRadial({width * (0.3f + 0.4f * random.NextFloat()),
+             height * (0.3f + 0.4f * random.NextFloat())},
+            std::min(width, height) * 0.2f);
+  SetNoise(seed, Core::Pi / 6.0f);
+}
 
-  for (int y = 0; y < m_Height; y++) {
-    for (int x = 0; x < m_Width; x++) {
-      int index = GetIndex(x, y);
+void TensorField::AddBasis(const Basis &basis) {
+  m_Bases.push_back(basis);
+  m_Dirty = true;
+}
+
+void TensorField::AddGrid(Core::Vec2 center, float angle, float radius,
+                          float weight) {
+  Basis basis;
+  basis.type = Basis::Type::Grid;
+  basis.center = center;
+  basis.angle = angle;
+  basis.radius = radius;
+  basis.weight = weight;
+  AddBasis(basis);
+}
+
+void TensorField::AddRadial(Core::Vec2 center, float radius, float weight) {
+  Basis basis;
+  basis.type = Basis::Type::Radial;
+  basis.center = center;
+  basis.radius = radius;
+  basis.weight = weight;
+  AddBasis(basis);
+}
+
+void TensorField::AddCoastline(const Data::Terrain &terrain, float spacing,
+                               float weight) {
+  if (terrain.width < 2 || terrain.depth < 2)
+    return;
+  int step = std::max(1, (int)std::lround(spacing / terrain.scale));
+  float sea = terrain.seaLevel;
 
-      // Map pixel intensity (0-255) to an angle (0 - PI)
-      // Tensor fields usually have 2 axes of symmetry, so 0-PI covers all lines
-      float intensity = pixels[index].r / 255.0f;
-      float angle = intensity * PI * 2.0f; // Full rotation for now to be safe
+  // One basis per block the sea level contour passes through, along the
+  // contour (perpendicular to the block's height gradient)
+  for (int z0 = 0; z0 < terrain.depth - 1; z0 += step) {
+    int z1 = std::min(z0 + step, terrain.depth - 1);
+    for (int x0 = 0; x0 < terrain.width - 1; x0 += step) {
+      int x1 = std::min(x0 + step, terrain.width - 1);
+      float h00 = terrain.GetHeight(x0, z0);
+      float h10 = terrain.GetHeight(x1, z0);
+      float h01 = terrain.GetHeight(x0, z1);
+      float h11 = terrain.GetHeight(x1, z1);
+      float lowest = std::min(std::min(h00, h10), std::min(h01, h11));
+      float highest = std::max(std::max(h00, h10), std::max(h01, h11));
+      if (lowest >= sea || highest < sea)
+        continue;
 
-      // Convert angle to vector
-      m_Grid[index] = {cosf(angle), sinf(angle)};
+      float gx = (h10 - h00 + h11 - h01) / (float)(x1 - x0);
+      float gz = (h01 - h00 + h11 - h10) / (float)(z1 - z0);
+      if (gx == 0.0f && gz == 0.0f)
+        continue;
+      Core::Vec2 center = {(float)(x0 + x1) * 0.5f * terrain.scale,
+                           (float)(z0 + z1) * 0.5f * terrain.scale};
+      AddGrid(center, std::atan2(gz, gx) + Core::Pi * 0.5f, spacing, weight);
     }
   }
-
-  UnloadImageColors(pixels);
-  UnloadImage(noiseImage);
 }
 
-Vector2 TensorField::Sample(float x, float z) const {
-  // Simple nearest neighbor or bilinear sampling
-  // Mapping world (x, z) to grid coordinates
-  // Assuming 1 unit = 1 cell for simplicity now
-  int gx = (int)x;
-  int gy = (int)z;
+void TensorField::AddRivers(const Data::RiverNetwork &network, float spacing,
+                            float weight) {
+  // One basis per chord of about `spacing` along each segment, which also
+  // smooths out the cell-to-cell zigzag of the river nodes
+  for (const auto &segment : network.segments) {
+    Core::Vec2 start = network.nodes[segment.nodes.front()].position;
+    float travelled = 0.0f;
+    for (int32_t i : segment.nodes) {
+      const auto &node = network.nodes[i];
+      if (node.downstream < 0)
+        break;
+      Core::Vec2 end = network.nodes[node.downstream].position;
+      travelled += std::hypot(end.x - node.position.x,
+                              end.y - node.position.y);
+      if (travelled < spacing)
+        continue;
+
+      Core::Vec2 center = {(start.x + end.x) * 0.5f,
+                           (start.y + end.y) * 0.5f};
+      AddGrid(center, std::atan2(end.y - start.y, end.x - start.x), spacing,
+              weight);
+      start = end;
+      travelled = 0.0f;
+    }
+  }
+}
 
-  // Clamp
-  if (gx < 0)
-    gx = 0;
-  if (gx >= m_Width)
-    gx = m_Width - 1;
-  if (gy < 0)
-    gy = 0;
-  if (gy >= m_Height)
-    gy = m_Height - 1;
+void TensorField::ClearBases() {
+  m_Bases.clear();
+  m_Dirty = true;
+}
 
-  return m_Grid[GetIndex(gx, gy)];
+void TensorField::SetNoise(int seed, float maxAngle) {
+  m_NoiseSeed = seed;
+  m_NoiseAngle = maxAngle;
+  m_Dirty = true;
 }
 
-int TensorField::GetIndex(int x, int y) const { return y * m_Width + x; }
+void TensorField::Evaluate() const {
+  if (!m_Dirty.load(std::memory_order_acquire))
+    return;
+  std::lock_guard<std::mutex> lock(m_EvaluateMutex);
+  if (!m_Dirty.load(std::memory_order_relaxed))
+    return;
 
-void TensorField::DrawDebug(float yLevel) {
-  // Draw a line for every cell
-  // Optimize: Draw every Nth cell to avoid clutter
-  int step = 2;
+  GENESIS_PROFILE_SCOPE("TensorField/Evaluate");
+  m_A.assign((size_t)m_Width * m_Height, 0.0f);
+  m_B.assign((size_t)m_Width * m_Height, 0.0f);
+  int blocks = (m_Height + BlockRows - 1) / BlockRows;
+  Core::ThreadPool::Get().ParallelFor(blocks, [&](int block) {
+    int z0 = block * BlockRows;
+    EvaluateRows(z0, std::min(z0 + BlockRows, m_Height));
+  });
+  m_Dirty.store(false, std::memory_order_release);
+}
 
-  for (int y = 0; y < m_Height; y += step) {
-    for (int x = 0; x < m_Width; x += step) {
-      Vector2 dir = m_Grid[GetIndex(x, y)];
+void TensorField::EvaluateRows(int z0, int z1) const {
+  for (const Basis &basis : m_Bases) {
+    // Only the cells within reach of a local basis
+    int bx0 = 0, bx1 = m_Width, bz0 = z0, bz1 = z1;
+    float invRadius2 = 0.0f;
+    if (basis.radius > 0.0f) {
+      float reach = basis.radius * ReachInRadii;
+      bx0 = std::max(0, (int)std::ceil(basis.center.x - reach));
+      bx1 = std::min(m_Width, (int)std::floor(basis.center.x + reach) + 1);
+      bz0 = std::max(z0, (int)std::ceil(basis.center.y - reach));
+      bz1 = std::min(z1, (int)std::floor(basis.center.y + reach) + 1);
+      invRadius2 = 1.0f / (basis.radius * basis.radius);
+    }
 
-      Vector3 start = {(float)x, yLevel, (float)y};
-      Vector3 end = {(float)x + dir.x * 0.8f, yLevel,
-                     (float)y + dir.y * 0.8f}; // Scale line by 0.8
+    Tensor grid = Tensor::FromAngle(basis.angle);
+    for (int z = bz0; z < bz1; z++) {
+      float *rowA = m_A.data() + (size_t)z * m_Width;
+      float *rowB = m_B.data() + (size_t)z * m_Width;
+      float dz = (float)z - basis.center.y;
+      for (int x = bx0; x < bx1; x++) {
+        float dx = (float)x - basis.center.x;
+        float distance2 = dx * dx + dz * dz;
+        float weight = basis.weight;
+        if (invRadius2 > 0.0f)
+          weight *= std::exp(-distance2 * invRadius2);
+
+        if (basis.type == Basis::Type::Grid) {
+          rowA[x] += weight * grid.a;
+          rowB[x] += weight * grid.b;
+        } else if (distance2 > 0.0f) {
+          // Major along the ring through (x, z)
+          weight /= distance2;
+          rowA[x] += weight * (dz * dz - dx * dx);
+          rowB[x] -= weight * 2.0f * dx * dz;
+        }
+      }
+    }
+  }
 
-      DrawLine3D(start, end, RED);
+  if (m_NoiseAngle == 0.0f)
+    return;
 
-      // Draw cross field (perpendicular)
-      Vector3 perpEnd = {(float)x + dir.y * 0.5f, yLevel,
-                         (float)y - dir.x * 0.5f};
-      DrawLine3D(start, perpEnd, BLUE);
+  // Rotating a direction by phi rotates its tensor by 2 * phi. Same fBm the
+  // field was originally built from (scale 5 across the grid).
+  Noise::FractalConfig noise;
+  noise.seed = m_NoiseSeed;
+  noise.frequency = 5.0f / (float)m_Width;
+  std::vector<float> row(m_Width);
+  for (int z = z0; z < z1; z++) {
+    Noise::FractalRow(row.data(), 0, z, m_Width, noise);
+    float *rowA = m_A.data() + (size_t)z * m_Width;
+    float *rowB = m_B.data() + (size_t)z * m_Width;
+    for (int x = 0; x < m_Width; x++) {
+      float rotation = 2.0f * m_NoiseAngle * std::clamp(row[x], -1.0f, 1.0f);
+      float c = std::cos(rotation);
+      float s = std::sin(rotation);
+      float a = rowA[x];
+      float b = rowB[x];
+      rowA[x] = a * c - b * s;
+      rowB[x] = a * s + b * c;
     }
   }
 }
 
+Tensor TensorField::SampleTensor(float x, float z) const {
+  Evaluate();
+  Float<1> a, b;
+  SampleLanes<1>(m_A.data(), m_B.data(), m_Width, m_Height, &x, &z, a, b);
+  return {a.v, b.v};
+}
+
+Core::Vec2 TensorField::Sample(float x, float z) const {
+  return SampleTensor(x, z).GetMajor();
+}
+
+void TensorField::Sample(const float *x, const float *z, int count,
+                         float *dirX, float *dirZ) const {
+  Evaluate();
+  const float *gridA = m_A.data();
+  const float *gridB = m_B.data();
+  int i = 0;
+  for (; i + NativeWidth <= count; i += NativeWidth) {
+    FloatN a, b, outX, outZ;
+    SampleLanes<NativeWidth>(gridA, gridB, m_Width, m_Height, x + i, z + i,
+                             a, b);
+    MajorDirection<NativeWidth>(a, b, outX, outZ);
+    outX.Store(dirX + i);
+    outZ.Store(dirZ + i);
+  }
+  for (; i < count; i++) {
+    Float<1> a, b, outX, outZ;
+    SampleLanes<1>(gridA, gridB, m_Width, m_Height, x + i, z + i, a, b);
+    MajorDirection<1>(a, b, outX, outZ);
+    dirX[i] = outX.v;
+    dirZ[i] = outZ.v;
+  }
+}
+
 } // namespace Genesis::Generator
@@ -1,38 +1,119 @@
 #pragma once
 
-#include "raylib.h"
+#include "../Core/Math.h"
+#include <atomic>
+#include <mutex>
 #include <vector>
 
+namespace Genesis::Data {
+struct Terrain;
+struct RiverNetwork;
+} // namespace Genesis::Data
+
 namespace Genesis::Generator {
 
+// Symmetric, traceless 2x2 tensor [a b; b -a] = r * [cos 2t, sin 2t; sin 2t,
+// -cos 2t]. Its major eigenvector points along angle t and the minor one is
+// perpendicular; t and t + pi give the same tensor, so opposite directions
+// blend instead of cancelling out.
+struct Tensor {
+  float a = 0.0f;
+  float b = 0.0f;
+
+  static Tensor FromAngle(float angle, float magnitude = 1.0f);
+
+  // Major eigenvector, unit length ({1, 0} for the zero tensor)
+  Core::Vec2 GetMajor() const;
+  Core::Vec2 GetMinor() const {
+    Core::Vec2 major = GetMajor();
+    return {-major.y, major.x};
+  }
+};
+
+// Direction field for street layout (Chen et al. 2008, "Interactive
+// Procedural Street Modeling"): a weighted sum of basis fields, optionally
+// rotated by noise, evaluated into a grid of tensors that Sample reads with
+// bilinear interpolation. Coordinates are world units; the grid has one
+// sample per world unit.
+//
+// Adding bases only records them. The grid is evaluated on the first sample
+// after a change (or by an explicit Evaluate), in parallel over rows.
 class TensorField {
 public:
+  struct Basis {
+    enum class Type {
+      Grid,   // Constant direction
+      Radial, // Rings around the center (major) and spokes (minor)
+    };
+    Type type = Type::Grid;
+    Core::Vec2 center;
+    float angle = 0.0f;  // Grid only: major direction, radians
+    float radius = 0.0f; // Gaussian falloff; 0 = same weight everywhere
+    float weight = 1.0f;
+  };
+
   TensorField(int width, int height);
   ~TensorField();
 
-  // Initialize the field with noise and some basic rules
+  // Replaces the bases with noise and some basic rules: a seeded global
+  // grid, a city-centre radial field and a little noise rotation. More bases
+  // can be added before the field is evaluated.
   void Generate(int seed);
 
   // Resize the grid
   void Resize(int width, int height);
 
-  // Get the primary direction at world coordinates
-  Vector2 Sample(float x, float z) const;
+  void AddBasis(const Basis &basis);
+  void AddGrid(Core::Vec2 center, float angle, float radius,
+               float weight = 1.0f);
+  void AddRadial(Core::Vec2 center, float radius, float weight = 1.0f);
+  // Grid bases every `spacing` world units along the coast (where the
+  // terrain crosses its sea level) and along the rivers, aligned with them
+  void AddCoastline(const Data::Terrain &terrain, float spacing,
+                    float weight = 1.0f);
+  void AddRivers(const Data::RiverNetwork &network, float spacing,
+                 float weight = 1.0f);
+  void ClearBases();
+  const std::vector<Basis> &GetBases() const { return m_Bases; }
 
-  // Draw debug lines for the field
-  void DrawDebug(float yLevel);
+  // Rotates the summed tensors by up to maxAngle radians of fBm noise
+  void SetNoise(int seed, float maxAngle);
+
+  // Builds the grid if anything changed since the last evaluation. Sampling
+  // does this itself; calling it up front keeps the cost out of the first
+  // sample.
+  void Evaluate() const;
+
+  // Bilinear blend of the four surrounding grid tensors, clamped to the grid
+  Tensor SampleTensor(float x, float z) const;
+
+  // Major direction at world coordinates (unit length)
+  Core::Vec2 Sample(float x, float z) const;
+
+  // Major directions for count points at once (SIMD where the build has it,
+  // with the same math as Sample)
+  void Sample(const float *x, const float *z, int count, float *dirX,
+              float *dirZ) const;
+
+  int GetWidth() const { return m_Width; }
+  int GetHeight() const { return m_Height; }
 
 private:
+  void EvaluateRows(int z0, int z1) const;
+
   int m_Width;
   int m_Height;
-  float m_Scale = 1.0f; // World units per grid cell
 
-  // We store the angle (in radians) for memory efficiency,
-  // or unit vectors. Let's store unit vectors.
-  std::vector<Vector2> m_Grid;
+  std::vector<Basis> m_Bases;
+  int m_NoiseSeed = 0;
+  float m_NoiseAngle = 0.0f;
 
-  // Helper to get grid index
-  int GetIndex(int x, int y) const;
+  // Evaluated tensors, one a/b pair per grid sample (separate arrays so
+  // SIMD sampling can gather straight from them)
+  mutable std::vector<float> m_A;
+  mutable std::vector<float> m_B;
+  mutable std::atomic<bool> m_Dirty{true};
+  mutable std::mutex m_EvaluateMutex;
 };
 
 } // namespace Genesis::Generator
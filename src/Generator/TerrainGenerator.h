@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../Core/Job.h"
 #include "../Data/World.h"
 
 namespace Genesis::Generator {
@@ -12,16 +13,40 @@ public:
     float noiseScale =
         0.1f; // High scale = Zoomed in (smooth), Low scale = Zoomed out (noisy)
     int seed = 12345;
+    int octaves = 6;
+    float lacunarity = 2.0f; // Frequency multiplier per octave
+    float gain = 0.5f;       // Amplitude multiplier per octave
     float heightMultiplier = 10.0f;
     float seaLevel = 0.2f; // Heights below this are water
+
+    bool operator==(const Config &) const = default;
   };
 
-  // Reads config, generates heightmap + mesh, writes to ctx.
-  static void Generate(Data::World &world, const Config &config);
+  // Reads config, generates the heightmap, writes to ctx. Everything is marked
+  // dirty so viewers rebuild from it. `progress` (optional) receives the
+  // fraction of tiles done; if it gets cancelled the terrain is left
+  // half-written and should be discarded.
+  static void Generate(Data::World &world, const Config &config,
+                       Core::JobProgress *progress = nullptr);
+
+  // Same terrain sampled at every `step`-th cell in each direction (so about
+  // 1/step^2 of the work), with Terrain::scale = step so it covers the same
+  // world area. Used for the editor's live preview.
+  static void GeneratePreview(Data::World &world, const Config &config,
+                              int step, Core::JobProgress *progress = nullptr);
+
+  // Copies the height multiplier and sea level into the terrain (useful after
+  // rivers/erosion, which run with the UI's current settings). Viewers notice
+  // the change and rebuild.
+  static void ApplyDisplaySettings(Data::Terrain *terrain,
+                                   const Config &config);
+
+private:
+  static void GenerateGrid(Data::World &world, const Config &config, int step,
+                           Core::JobProgress *progress);
 
-  // Rebuilds just the mesh from existing terrain data (useful after
-  // rivers/erosion)
-  static void RebuildMesh(Data::Terrain *terrain, const Config &config);
+  // Heightmap generation work unit (cells per side)
+  static constexpr int TileSize = 64;
 };
 
 } // namespace Genesis::Generator
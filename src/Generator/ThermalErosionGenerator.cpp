@@ -0,0 +1,205 @@
+#include "ThermalErosionGenerator.h"
+#include "../Core/Math.h"
+#include "../Core/Profiler.h"
+#include "../Core/Simd.h"
+#include "../Core/ThreadPool.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace Genesis::Generator {
+
+using namespace Genesis::Core::Simd;
+
+namespace {
+
+// Height of the 1-cell border around the grid. Nothing flows into it (the
+// drop is negative) and its outflow factor is 0, so edges keep their mass.
+constexpr float BorderHeight = 1e30f;
+
+struct Neighbour {
+  int offset;      // In the padded height buffers
+  int localOffset; // In a block's outflow factors
+  float talus;     // Largest stable height difference
+};
+
+using Neighbours = std::array<Neighbour, 8>;
+
+// Share of each cell's excess it sheds this iteration: it moves
+// rate * (largest excess) / 2 in total, split over the lower neighbours in
+// proportion to their excess
+template <int W>
+Float<W> OutflowFactor(const float *h, const Neighbours &neighbours,
+                       float rate) {
+  Float<W> zero(0.0f);
+  Float<W> center = Float<W>::Load(h);
+  Float<W> sum(0.0f);
+  Float<W> largest(0.0f);
+  for (const Neighbour &n : neighbours) {
+    Float<W> excess = Max(zero, center - Float<W>::Load(h + n.offset) -
+                                    Float<W>(n.talus));
+    sum = sum + excess;
+    largest = Max(largest, excess);
+  }
+  return Select(sum > zero, Float<W>(rate * 0.5f) * largest / sum, zero);
+}
+
+// New height: what slides in from higher neighbours minus what slides out
+template <int W>
+Float<W> Gather(const float *h, const float *factor,
+                const Neighbours &neighbours) {
+  Float<W> zero(0.0f);
+  Float<W> center = Float<W>::Load(h);
+  Float<W> own = Float<W>::Load(factor);
+  Float<W> delta(0.0f);
+  for (const Neighbour &n : neighbours) {
+    Float<W> drop = center - Float<W>::Load(h + n.offset);
+    Float<W> talus(n.talus);
+    Float<W> out = Max(zero, drop - talus);
+    Float<W> in = Max(zero, zero - drop - talus);
+    delta = delta + Float<W>::Load(factor + n.localOffset) * in - own * out;
+  }
+  return center + delta;
+}
+
+} // namespace
+
+void ThermalErosionGenerator::Execute(
+    Data::World &world, const Config &config,
+    const TerrainGenerator::Config &terrainConfig,
+    Core::JobProgress *progress) {
+  GENESIS_PROFILE_SCOPE("Thermal/Execute");
+  if (!world.terrain)
+    return;
+  auto terrain = world.terrain.get();
+
+  // Same snapshot logic as hydraulic erosion: repeated runs restart from the
+  // heightmap the first run saw. Tiles erosion didn't reach are shared with
+  // the erosion snapshot.
+  if (!terrain->preThermalHeightMap.Matches(terrain->width, terrain->depth)) {
+    const Data::StageLayer *parent =
+        terrain->preErosionHeightMap.IsEmpty() ? &terrain->baseHeightMap
+                                               : &terrain->preErosionHeightMap;
+    terrain->preThermalHeightMap.Capture(terrain->heightMap, terrain->width,
+                                         terrain->depth, parent);
+  } else {
+    terrain->MarkDirty(
+        terrain->preThermalHeightMap.Restore(terrain->heightMap));
+  }
+
+  int width = terrain->width;
+  int depth = terrain->depth;
+  if (width < 2 || depth < 2)
+    return;
+
+  // The angle is in world space; heights are stored raw (0-1) and cells are
+  // `scale` apart
+  float heightScale =
+      terrainConfig.heightMultiplier > 0.0f ? terrainConfig.heightMultiplier
+                                            : 1.0f;
+  float talus = std::tan(config.talusAngle * Core::Pi / 180.0f) *
+                terrain->scale / heightScale;
+
+  // Double buffer with a border so the stencil needs no edge cases
+  int stride = width + 2;
+  std::vector<float> current((size_t)stride * (depth + 2), BorderHeight);
+  std::vector<float> next(current.size(), BorderHeight);
+  for (int z = 0; z < depth; z++)
+    std::copy_n(terrain->heightMap.data() + z * width, width,
+                current.data() + (z + 1) * stride + 1);
+
+  int localStride = BlockCols + 2;
+  Neighbours neighbours;
+  int n = 0;
+  for (int dz = -1; dz <= 1; dz++) {
+    for (int dx = -1; dx <= 1; dx++) {
+      if (dx == 0 && dz == 0)
+        continue;
+      float distance = (dx != 0 && dz != 0) ? std::sqrt(2.0f) : 1.0f;
+      neighbours[n++] = {dz * stride + dx, dz * localStride + dx,
+                         talus * distance};
+    }
+  }
+
+  int blocksX = (width + BlockCols - 1) / BlockCols;
+  int blocksZ = (depth + BlockRows - 1) / BlockRows;
+  constexpr int W = NativeWidth;
+
+  GENESIS_PROFILE_SCOPE("Thermal/Iterations");
+  for (int iter = 0; iter < config.iterations; iter++) {
+    if (progress) {
+      if (progress->IsCancelled())
+        return;
+      progress->Set((float)iter / config.iterations);
+    }
+
+    const float *source = current.data();
+    float *target = next.data();
+    Core::ThreadPool::Get().ParallelFor(blocksX * blocksZ, [&](int block) {
+      int x0 = (block % blocksX) * BlockCols;
+      int z0 = (block / blocksX) * BlockRows;
+      int x1 = std::min(x0 + BlockCols, width);
+      int z1 = std::min(z0 + BlockRows, depth);
+
+      // Outflow factors of the block plus a 1-cell halo, in scratch each
+      // thread keeps across blocks and iterations. Everything inside the
+      // grid is overwritten below; halo cells outside it must read 0.
+      thread_local std::vector<float> factors;
+      factors.resize((size_t)localStride * (BlockRows + 2));
+      int localCols = x1 - x0 + 2;
+      int localRows = z1 - z0 + 2;
+      if (z0 == 0)
+        std::fill_n(factors.data(), localCols, 0.0f);
+      if (z1 == depth)
+        std::fill_n(factors.data() + (localRows - 1) * localStride, localCols,
+                    0.0f);
+      if (x0 == 0 || x1 == width) {
+        for (int z = 0; z < localRows; z++) {
+          float *row = factors.data() + z * localStride;
+          if (x0 == 0)
+            row[0] = 0.0f;
+          if (x1 == width)
+            row[localCols - 1] = 0.0f;
+        }
+      }
+      int hx0 = std::max(x0 - 1, 0);
+      int hx1 = std::min(x1 + 1, width);
+      for (int z = std::max(z0 - 1, 0); z < std::min(z1 + 1, depth); z++) {
+        const float *row = source + (z + 1) * stride + 1;
+        float *out = factors.data() + (z - z0 + 1) * localStride + 1;
+        int x = hx0;
+        if constexpr (W > 1) {
+          for (; x + W <= hx1; x += W)
+            OutflowFactor<W>(row + x, neighbours, config.rate)
+                .Store(out + (x - x0));
+        }
+        for (; x < hx1; x++)
+          out[x - x0] = OutflowFactor<1>(row + x, neighbours, config.rate).v;
+      }
+
+      for (int z = z0; z < z1; z++) {
+        const float *row = source + (z + 1) * stride + 1;
+        float *result = target + (z + 1) * stride + 1;
+        const float *factor = factors.data() + (z - z0 + 1) * localStride + 1;
+        int x = x0;
+        if constexpr (W > 1) {
+          for (; x + W <= x1; x += W)
+            Gather<W>(row + x, factor + (x - x0), neighbours)
+                .Store(result + x);
+        }
+        for (; x < x1; x++)
+          result[x] = Gather<1>(row + x, factor + (x - x0), neighbours).v;
+      }
+    });
+    std::swap(current, next);
+  }
+
+  for (int z = 0; z < depth; z++)
+    std::copy_n(current.data() + (z + 1) * stride + 1, width,
+                terrain->heightMap.data() + z * width);
+  terrain->MarkAllDirty();
+  TerrainGenerator::ApplyDisplaySettings(terrain, terrainConfig);
+}
+
+} // namespace Genesis::Generator
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "../Core/Job.h"
+#include "../Data/World.h"
+#include "TerrainGenerator.h"
+
+namespace Genesis::Generator {
+
+// Thermal weathering: wherever the drop to a neighbour is steeper than the
+// talus angle, material slides down until it isn't. Softens the cliffs that
+// hydraulic erosion leaves behind.
+class ThermalErosionGenerator {
+public:
+  struct Config {
+    int iterations = 50;
+    float talusAngle = 35.0f; // Degrees; steeper slopes shed material
+    float rate = 0.5f;        // Fraction of the excess moved per iteration
+  };
+
+  // Each iteration reads one height buffer and writes the other, so every
+  // cell can be updated in parallel: first each cell's outflow factor, then
+  // every cell gathers what it gains from its 8 neighbours minus what it
+  // sheds (mass-conserving). Both steps run fused per block of the grid
+  // (cache-sized, with a 1-cell halo) on the thread pool, vectorized along
+  // rows.
+  //
+  // Like ErosionGenerator::Execute, the first run snapshots the heightmap
+  // (Terrain::preThermalHeightMap) and later runs restart from it, so
+  // repeated runs don't stack. `progress` (optional) receives the fraction
+  // of iterations done and stops the run early when cancelled.
+  static void Execute(Data::World &world, const Config &config,
+                      const TerrainGenerator::Config &terrainConfig,
+                      Core::JobProgress *progress = nullptr);
+
+private:
+  // Block of cells one task updates per iteration
+  static constexpr int BlockRows = 32;
+  static constexpr int BlockCols = 256;
+};
+
+} // namespace Genesis::Generator
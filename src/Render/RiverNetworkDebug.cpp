@@ -0,0 +1,37 @@
+#include "RiverNetworkDebug.h"
+#include "raylib.h"
+#include <algorithm>
+
+namespace Genesis::Render {
+
+void DrawRiverNetworkDebug(const Data::RiverNetwork &network,
+                           float heightMultiplier) {
+  // Lifted a little so the lines don't z-fight with the river cells
+  const float lift = 0.05f;
+  auto toWorld = [&](const Data::RiverNetwork::Node &node) {
+    return Vector3{node.position.x, node.height * heightMultiplier + lift,
+                   node.position.y};
+  };
+
+  for (const auto &segment : network.segments) {
+    unsigned char shade = (unsigned char)std::min(255, 95 + segment.order * 40);
+    Color color = {0, shade, 255, 255};
+    for (int32_t i : segment.nodes) {
+      const auto &node = network.nodes[i];
+      if (node.downstream >= 0)
+        DrawLine3D(toWorld(node), toWorld(network.nodes[node.downstream]),
+                   color);
+    }
+  }
+
+  for (const auto &node : network.nodes) {
+    if (node.upstreamCount < 2)
+      continue;
+    Vector3 p = toWorld(node);
+    float r = std::max(node.width * 0.5f, 0.25f);
+    DrawLine3D({p.x - r, p.y, p.z}, {p.x + r, p.y, p.z}, WHITE);
+    DrawLine3D({p.x, p.y, p.z - r}, {p.x, p.y, p.z + r}, WHITE);
+  }
+}
+
+} // namespace Genesis::Render
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "../Data/RiverNetwork.h"
+
+namespace Genesis::Render {
+
+// Draw the river graph as lines just above the terrain, brighter for higher
+// Strahler orders, with a cross at every confluence. Must be called between
+// BeginMode3D/EndMode3D.
+void DrawRiverNetworkDebug(const Data::RiverNetwork &network,
+                           float heightMultiplier);
+
+} // namespace Genesis::Render
@@ -0,0 +1,29 @@
+#include "TensorFieldDebug.h"
+#include "raylib.h"
+
+namespace Genesis::Render {
+
+void DrawTensorFieldDebug(const Generator::TensorField &field, float yLevel) {
+  // Draw a line for every cell
+  // Optimize: Draw every Nth cell to avoid clutter
+  int step = 2;
+
+  for (int y = 0; y < field.GetHeight(); y += step) {
+    for (int x = 0; x < field.GetWidth(); x += step) {
+      Core::Vec2 dir = field.Sample((float)x, (float)y);
+
+      Vector3 start = {(float)x, yLevel, (float)y};
+      Vector3 end = {(float)x + dir.x * 0.8f, yLevel,
+                     (float)y + dir.y * 0.8f}; // Scale line by 0.8
+
+      DrawLine3D(start, end, RED);
+
+      // Draw cross field (perpendicular)
+      Vector3 perpEnd = {(float)x + dir.y * 0.5f, yLevel,
+                         (float)y - dir.x * 0.5f};
+      DrawLine3D(start, perpEnd, BLUE);
+    }
+  }
+}
+
+} // namespace Genesis::Render
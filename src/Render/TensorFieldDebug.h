@@ -0,0 +1,11 @@
+#pragma once
+
+#include "../Generator/TensorField.h"
+
+namespace Genesis::Render {
+
+// Draw debug lines for the field (major direction in red, the perpendicular
+// cross field in blue). Must be called between BeginMode3D/EndMode3D.
+void DrawTensorFieldDebug(const Generator::TensorField &field, float yLevel);
+
+} // namespace Genesis::Render
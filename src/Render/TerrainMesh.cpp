@@ -0,0 +1,633 @@
+#include "TerrainMesh.h"
+#include "../Core/Profiler.h"
+#include "../Core/ThreadPool.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Genesis::Render {
+
+const Color TerrainMesh::Palette[PaletteSize] = {
+    {0, 105, 148, 255}, // Deep Sea Blue
+    BEIGE,              // Sand
+    DARKGREEN,          // Grass
+    GRAY,               // Rock
+    WHITE,              // Snow
+    BLUE,               // River
+};
+
+int TerrainMesh::GetPaletteIndex(float h, float seaLevel, int riverType) {
+  if (riverType > 0)
+    return 5;
+  if (h < seaLevel)
+    return 0;
+  if (h < seaLevel + 0.05f)
+    return 1;
+  if (h < 0.6f)
+    return 2;
+  if (h < 0.8f)
+    return 3;
+  return 4;
+}
+
+namespace {
+
+// Octahedral normal encoding into two unsigned bytes
+void EncodeOctahedral(Vector3 n, unsigned char out[2]) {
+  float sum = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+  float u = n.x / sum;
+  float v = n.z / sum;
+  if (n.y < 0.0f) {
+    float fu = (1.0f - std::fabs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+    float fv = (1.0f - std::fabs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+    u = fu;
+    v = fv;
+  }
+  out[0] = (unsigned char)std::lround((u * 0.5f + 0.5f) * 255.0f);
+  out[1] = (unsigned char)std::lround((v * 0.5f + 0.5f) * 255.0f);
+}
+
+// Helper to calculate vertex normal using central differences. `spacing` is
+// the world distance between neighbouring samples.
+Vector3 GetVertexNormal(const Data::Terrain &terrain, int x, int z,
+                        float heightMultiplier, float spacing) {
+  float hL = terrain.GetHeight(x - 1, z) * heightMultiplier;
+  float hR = terrain.GetHeight(x + 1, z) * heightMultiplier;
+  float hD = terrain.GetHeight(x, z - 1) * heightMultiplier;
+  float hU = terrain.GetHeight(x, z + 1) * heightMultiplier;
+
+  // Vectors corresponding to the slope
+  Vector3 vHorizontal = {2.0f * spacing, hR - hL, 0.0f};
+  Vector3 vVertical = {0.0f, hU - hD, 2.0f * spacing};
+
+  return Vector3Normalize(Vector3CrossProduct(vVertical, vHorizontal));
+}
+
+} // namespace
+
+TerrainMesh::~TerrainMesh() { Unload(); }
+
+void TerrainMesh::Update(Data::Terrain &terrain) {
+  if (terrain.heightMap.empty())
+    return;
+
+  int width = terrain.width;
+  int depth = terrain.depth;
+  if (width < 2 || depth < 2)
+    return;
+
+  // Reuse the existing CPU arrays and VBOs whenever the grid layout is the
+  // same. Only a new size reallocates and re-uploads.
+  bool reuse = isLoaded && this->width == width && this->depth == depth &&
+               packed == settings.packedVertices;
+
+  // Normals read the 4 neighbours, so a changed height touches them too
+  Data::GridRegion heights = terrain.dirty;
+  heights.Expand(1, width, depth);
+  if (!reuse || scale != terrain.scale)
+    heights = Data::GridRegion::Full(width, depth);
+
+  // Every vertex depends on the display settings, but the heights (and with
+  // them the textures) don't
+  bool displayChanged = heightMultiplier != terrain.heightMultiplier ||
+                        seaLevel != terrain.seaLevel;
+  bool rebuildAll = !reuse || scale != terrain.scale ||
+                    (displayChanged && !settings.displayOnGpu);
+  Data::GridRegion region =
+      rebuildAll ? Data::GridRegion::Full(width, depth) : heights;
+
+  if (!settings.adaptive && adaptive)
+    UnloadAdaptive();
+  bool retriangulate = settings.adaptive && reuse &&
+                       (!adaptive || maxError != settings.maxError);
+
+  terrain.dirty = {};
+  if (region.IsEmpty()) {
+    if (retriangulate)
+      UpdateAdaptive(terrain, region, true);
+    return;
+  }
+
+  GENESIS_PROFILE_SCOPE("Mesh/Update");
+  if (!reuse)
+    Allocate(terrain, settings.packedVertices);
+  // Deferred display changes keep the old values, so partial updates still
+  // match the rest of the mesh
+  if (rebuildAll) {
+    heightMultiplier = terrain.heightMultiplier;
+    seaLevel = terrain.seaLevel;
+    scale = terrain.scale;
+  }
+
+  WriteVertices(terrain, region);
+
+  constexpr int Quads = ChunkQuads;
+  constexpr int Verts = ChunkVerts;
+
+  // Chunks the region overlaps. A region starting on a chunk's first
+  // row/column also touches the border copy stored in the previous chunk.
+  int cx0 = std::min(region.x0 / Quads, chunksX - 1);
+  int cx1 = std::min(region.x1 / Quads, chunksX - 1);
+  int cz0 = std::min(region.z0 / Quads, chunksZ - 1);
+  int cz1 = std::min(region.z1 / Quads, chunksZ - 1);
+  if (cx0 > 0 && region.x0 % Quads == 0)
+    cx0--;
+  if (cz0 > 0 && region.z0 % Quads == 0)
+    cz0--;
+
+  for (int cz = cz0; cz <= cz1; cz++) {
+    for (int cx = cx0; cx <= cx1; cx++) {
+      int chunk = cz * chunksX + cx;
+      UpdateChunkHeightRange(terrain, cx, cz);
+
+      if (!reuse)
+        continue;
+
+      // Push only the dirty rows. Padding rows past the last grid row mirror
+      // it, so they go along when the region reaches the bottom edge.
+      int z0 = cz * Quads;
+      int rowFirst = std::max(region.z0 - z0, 0);
+      int rowLast = region.z1 == depth - 1 ? Quads
+                                           : std::min(region.z1 - z0, Quads);
+      if (rowFirst > rowLast)
+        continue;
+
+      GENESIS_PROFILE_SCOPE("Mesh/Upload");
+      int first = rowFirst * Verts;
+      int count = (rowLast - rowFirst + 1) * Verts;
+      if (packed) {
+        PackedChunk &packedChunk = packedChunks[chunk];
+        rlUpdateVertexBuffer(packedChunk.heightVboId,
+                             packedChunk.heights.data() + first,
+                             count * sizeof(unsigned short),
+                             first * sizeof(unsigned short));
+        rlUpdateVertexBuffer(packedChunk.attributeVboId,
+                             packedChunk.attributes.data() + first * 4,
+                             count * 4, first * 4);
+        continue;
+      }
+
+      Mesh &mesh = model.meshes[chunk];
+      UpdateMeshBuffer(mesh, 0, mesh.vertices + first * 3,
+                       count * 3 * sizeof(float), first * 3 * sizeof(float));
+      UpdateMeshBuffer(mesh, 2, mesh.normals + first * 3,
+                       count * 3 * sizeof(float), first * 3 * sizeof(float));
+      UpdateMeshBuffer(mesh, 3, mesh.colors + first * 4,
+                       count * 4 * sizeof(unsigned char),
+                       first * 4 * sizeof(unsigned char));
+    }
+  }
+
+  if (!reuse) {
+    GENESIS_PROFILE_SCOPE("Mesh/Upload");
+    if (packed) {
+      for (auto &packedChunk : packedChunks)
+        UploadPackedChunk(packedChunk);
+    } else {
+      for (int i = 0; i < model.meshCount; i++)
+        UploadMesh(&model.meshes[i], true);
+    }
+    isLoaded = true;
+  }
+
+  if (settings.adaptive)
+    UpdateAdaptive(terrain, region, retriangulate || !reuse);
+
+  textureDirty.Include(heights);
+}
+
+void TerrainMesh::Allocate(const Data::Terrain &terrain, bool packedLayout) {
+  Unload();
+  width = terrain.width;
+  depth = terrain.depth;
+
+  constexpr int Quads = ChunkQuads;
+  constexpr int Verts = ChunkVerts;
+
+  // The grid is split into chunks of ChunkQuads quads per side so every
+  // chunk stays addressable with raylib's 16-bit indices. All chunks share
+  // one layout (the last row/column of chunks is padded by repeating the
+  // grid's edge), which lets the renderer use one set of LOD index buffers
+  // for every chunk. Vertices are shared inside a chunk; only the
+  // row/column on a chunk border is stored twice.
+  chunksX = (terrain.width - 2) / Quads + 1;
+  chunksZ = (terrain.depth - 2) / Quads + 1;
+  int chunkCount = chunksX * chunksZ;
+
+  packed = packedLayout;
+  chunkHeightRange.assign(chunkCount, Vector2{0.0f, 0.0f});
+
+  if (packed) {
+    packedChunks.resize(chunkCount);
+    for (auto &chunk : packedChunks) {
+      chunk.heights.resize(Verts * Verts);
+      chunk.attributes.resize(Verts * Verts * 4);
+    }
+    return;
+  }
+
+  model = {0};
+  model.transform = MatrixIdentity();
+  model.meshCount = chunkCount;
+  model.meshes = (Mesh *)MemAlloc(chunkCount * sizeof(Mesh));
+  model.materialCount = 1;
+  model.materials = (Material *)MemAlloc(sizeof(Material));
+  model.materials[0] = LoadMaterialDefault();
+  // Default material uses VERTEX_COLOR
+  model.materials[0].maps[MATERIAL_MAP_DIFFUSE].color = WHITE;
+  model.meshMaterial = (int *)MemAlloc(chunkCount * sizeof(int));
+
+  // Triangles come from the renderer's shared index buffers, so the chunk
+  // meshes only carry vertex data
+  for (int i = 0; i < chunkCount; i++) {
+    Mesh &mesh = model.meshes[i];
+    mesh.vertexCount = Verts * Verts;
+    mesh.triangleCount = Quads * Quads * 2;
+    mesh.vertices = (float *)MemAlloc(mesh.vertexCount * 3 * sizeof(float));
+    mesh.normals = (float *)MemAlloc(mesh.vertexCount * 3 * sizeof(float));
+    mesh.colors = (unsigned char *)MemAlloc(mesh.vertexCount * 4 *
+                                            sizeof(unsigned char));
+  }
+}
+
+void TerrainMesh::UploadPackedChunk(PackedChunk &chunk) {
+  // rlgl has no constant for GL_UNSIGNED_SHORT
+  constexpr int GlUnsignedShort = 0x1403;
+
+  chunk.vaoId = rlLoadVertexArray();
+  rlEnableVertexArray(chunk.vaoId);
+
+  // Location 0: normalized height, location 1: normal/palette bytes. Both
+  // buffers are tightly packed, so stride and offset are 0.
+  int heightBytes = (int)(chunk.heights.size() * sizeof(unsigned short));
+  chunk.heightVboId =
+      rlLoadVertexBuffer(chunk.heights.data(), heightBytes, true);
+  rlSetVertexAttribute(0, 1, GlUnsignedShort, true, 0, 0);
+  rlEnableVertexAttribute(0);
+
+  chunk.attributeVboId = rlLoadVertexBuffer(
+      chunk.attributes.data(), (int)chunk.attributes.size(), true);
+  rlSetVertexAttribute(1, 4, RL_UNSIGNED_BYTE, true, 0, 0);
+  rlEnableVertexAttribute(1);
+
+  rlDisableVertexArray();
+}
+
+void TerrainMesh::WriteVertices(const Data::Terrain &terrain,
+                                const Data::GridRegion &region) {
+  GENESIS_PROFILE_SCOPE("Mesh/Vertices");
+  constexpr int Quads = ChunkQuads;
+  constexpr int Verts = ChunkVerts;
+  Mesh *meshes = model.meshes;
+
+  // Row-parallel vertex pass: every sample's position, normal and color is
+  // computed exactly once, then written into each chunk slot that shares it
+  // (1 for interior samples, 2-4 on chunk borders, a whole padding strip for
+  // the grid's last row/column).
+  Core::ThreadPool::Get().ParallelFor(region.z1 - region.z0 + 1, [&](int row) {
+    int z = region.z0 + row;
+    int czLast = std::min(z / Quads, chunksZ - 1);
+    int czFirst = (z % Quads == 0 && z > 0) ? czLast - 1 : czLast;
+    if (z == depth - 1)
+      czFirst = czLast;
+
+    for (int x = region.x0; x <= region.x1; x++) {
+      float h = terrain.GetHeight(x, z);
+      Vector3 n = GetVertexNormal(terrain, x, z, heightMultiplier, scale);
+      int palette = GetPaletteIndex(h, seaLevel, terrain.GetRiverType(x, z));
+      Color c = Palette[palette];
+
+      unsigned short quantized = 0;
+      unsigned char octahedral[2] = {0, 0};
+      if (packed) {
+        quantized = (unsigned short)std::lround(std::clamp(h, 0.0f, 1.0f) *
+                                                65535.0f);
+        EncodeOctahedral(n, octahedral);
+      }
+
+      int cxLast = std::min(x / Quads, chunksX - 1);
+      int cxFirst = (x % Quads == 0 && x > 0) ? cxLast - 1 : cxLast;
+      if (x == width - 1)
+        cxFirst = cxLast;
+
+      for (int cz = czFirst; cz <= czLast; cz++) {
+        int lz0 = z - cz * Quads;
+        int lz1 = z == depth - 1 ? Quads : lz0;
+
+        for (int cx = cxFirst; cx <= cxLast; cx++) {
+          int lx0 = x - cx * Quads;
+          int lx1 = x == width - 1 ? Quads : lx0;
+
+          if (packed) {
+            PackedChunk &chunk = packedChunks[cz * chunksX + cx];
+            for (int lz = lz0; lz <= lz1; lz++) {
+              for (int lx = lx0; lx <= lx1; lx++) {
+                int v = lz * Verts + lx;
+                chunk.heights[v] = quantized;
+                chunk.attributes[v * 4] = octahedral[0];
+                chunk.attributes[v * 4 + 1] = octahedral[1];
+                chunk.attributes[v * 4 + 2] = (unsigned char)palette;
+                chunk.attributes[v * 4 + 3] = 0;
+              }
+            }
+            continue;
+          }
+
+          Mesh &mesh = meshes[cz * chunksX + cx];
+          for (int lz = lz0; lz <= lz1; lz++) {
+            for (int lx = lx0; lx <= lx1; lx++) {
+              int v = lz * Verts + lx;
+              mesh.vertices[v * 3] = (float)x;
+              mesh.vertices[v * 3 + 1] = h * heightMultiplier;
+              mesh.vertices[v * 3 + 2] = (float)z;
+              mesh.normals[v * 3] = n.x;
+              mesh.normals[v * 3 + 1] = n.y;
+              mesh.normals[v * 3 + 2] = n.z;
+              mesh.colors[v * 4] = c.r;
+              mesh.colors[v * 4 + 1] = c.g;
+              mesh.colors[v * 4 + 2] = c.b;
+              mesh.colors[v * 4 + 3] = c.a;
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+void TerrainMesh::UpdateChunkHeightRange(const Data::Terrain &terrain, int cx,
+                                         int cz) {
+  constexpr int Quads = ChunkQuads;
+  int x0 = cx * Quads;
+  int z0 = cz * Quads;
+  int x1 = std::min(x0 + Quads, terrain.width - 1);
+  int z1 = std::min(z0 + Quads, terrain.depth - 1);
+
+  float minH = terrain.heightMap[z0 * terrain.width + x0];
+  float maxH = minH;
+  for (int z = z0; z <= z1; z++) {
+    const float *row = &terrain.heightMap[z * terrain.width];
+    for (int x = x0; x <= x1; x++) {
+      minH = std::min(minH, row[x]);
+      maxH = std::max(maxH, row[x]);
+    }
+  }
+
+  chunkHeightRange[cz * chunksX + cx] = {minH, maxH};
+}
+
+// Adaptive meshing follows the right-triangulated irregular network (RTIN)
+// scheme: every triangle is a right isosceles triangle that splits at the
+// midpoint of its hypotenuse. A vertex's error is the largest vertical
+// distance between the terrain and the linear interpolation across the
+// hypotenuse, over it and all vertices below it in the split hierarchy, so
+// "error > maxError" splits a triangle exactly when some descendant needs it.
+// As in Martini, errors are measured at split midpoints, so maxError bounds
+// those rather than every sample under the final triangles (in practice
+// the worst sample stays within about 2x).
+//
+// Errors are kept per vertex of the whole padded chunk grid instead of per
+// chunk. The two triangles sharing a chunk-border hypotenuse both read the
+// same error, so neighbouring chunks always agree on their shared edge
+// vertices and the triangulation is crack-free without skirts.
+namespace {
+
+struct MeshErrorGrid {
+  const Data::Terrain *terrain;
+  float heightMultiplier;
+  int gridWidth; // Vertices per row of the padded chunk grid
+  int gridDepth;
+  float *errors;
+
+  // Heights of the padded grid: samples past the map repeat its edge, the
+  // same way the chunk meshes are padded
+  float Height(int x, int z) const {
+    x = std::min(x, terrain->width - 1);
+    z = std::min(z, terrain->depth - 1);
+    return terrain->heightMap[z * terrain->width + x] * heightMultiplier;
+  }
+
+  float Error(int x, int z) const {
+    if (x < 0 || z < 0 || x >= gridWidth || z >= gridDepth)
+      return 0.0f;
+    return errors[z * gridWidth + x];
+  }
+};
+
+// Calls fn(x, z) for every grid point inside [x0, x1] x [z0, z1] with
+// x = xOffset (mod xStep) and z = zOffset (mod zStep), one row per task
+template <typename Fn>
+void ForEachLatticePoint(int x0, int z0, int x1, int z1, int xOffset,
+                         int xStep, int zOffset, int zStep, const Fn &fn) {
+  auto first = [](int lo, int offset, int step) {
+    return lo <= offset ? offset
+                        : offset + (lo - offset + step - 1) / step * step;
+  };
+  int zFirst = first(z0, zOffset, zStep);
+  int xFirst = first(x0, xOffset, xStep);
+  if (zFirst > z1 || xFirst > x1)
+    return;
+
+  int rows = (z1 - zFirst) / zStep + 1;
+  Core::ThreadPool::Get().ParallelFor(rows, [&](int row) {
+    int z = zFirst + row * zStep;
+    for (int x = xFirst; x <= x1; x += xStep)
+      fn(x, z);
+  });
+}
+
+// Recomputes the errors of every vertex in [x0, x1] x [z0, z1], finest level
+// first. Vertices of one pass never depend on each other, so each pass runs
+// in parallel.
+void ComputeMeshErrors(const MeshErrorGrid &grid, int x0, int z0, int x1,
+                       int z1) {
+  constexpr int Quads = TerrainMesh::ChunkQuads;
+
+  for (int s = 1; s < Quads; s *= 2) {
+    int h = s / 2;
+
+    // Midpoints of axis-aligned hypotenuses of length 2s. Their children are
+    // the centers of the four s-sized squares touching them.
+    auto axisMidpoint = [&](int x, int z, int dx, int dz) {
+      float interpolated =
+          (grid.Height(x - dx, z - dz) + grid.Height(x + dx, z + dz)) * 0.5f;
+      float error = std::fabs(grid.Height(x, z) - interpolated);
+      if (h > 0) {
+        error = std::max({error, grid.Error(x - h, z - h),
+                          grid.Error(x + h, z - h), grid.Error(x - h, z + h),
+                          grid.Error(x + h, z + h)});
+      }
+      grid.errors[z * grid.gridWidth + x] = error;
+    };
+    ForEachLatticePoint(x0, z0, x1, z1, s, 2 * s, 0, 2 * s,
+                        [&](int x, int z) { axisMidpoint(x, z, s, 0); });
+    ForEachLatticePoint(x0, z0, x1, z1, 0, 2 * s, s, 2 * s,
+                        [&](int x, int z) { axisMidpoint(x, z, 0, s); });
+
+    // Centers of 2s-sized squares, split along the diagonal that points at
+    // the parent square's center. Their children are the square's four edge
+    // midpoints.
+    ForEachLatticePoint(x0, z0, x1, z1, s, 2 * s, s, 2 * s, [&](int x, int z) {
+      bool mainDiagonal = ((x / (2 * s)) + (z / (2 * s))) % 2 == 0;
+      float a = mainDiagonal ? grid.Height(x - s, z - s)
+                             : grid.Height(x + s, z - s);
+      float b = mainDiagonal ? grid.Height(x + s, z + s)
+                             : grid.Height(x - s, z + s);
+      float error = std::fabs(grid.Height(x, z) - (a + b) * 0.5f);
+      error = std::max({error, grid.Error(x - s, z), grid.Error(x + s, z),
+                        grid.Error(x, z - s), grid.Error(x, z + s)});
+      grid.errors[z * grid.gridWidth + x] = error;
+    });
+  }
+}
+
+// Emits the RTIN triangles of one chunk. (ax, az)-(bx, bz) is the hypotenuse
+// and (cx, cz) the right-angle corner, in chunk-local coordinates.
+void TriangulateRtin(const MeshErrorGrid &grid, int originX, int originZ,
+                     float maxError, int ax, int az, int bx, int bz, int cx,
+                     int cz, std::vector<unsigned short> &indices) {
+  constexpr int Verts = TerrainMesh::ChunkVerts;
+  int mx = (ax + bx) / 2;
+  int mz = (az + bz) / 2;
+
+  if (std::abs(ax - cx) + std::abs(az - cz) > 1 &&
+      grid.Error(originX + mx, originZ + mz) > maxError) {
+    TriangulateRtin(grid, originX, originZ, maxError, cx, cz, ax, az, mx, mz,
+                    indices);
+    TriangulateRtin(grid, originX, originZ, maxError, bx, bz, cx, cz, mx, mz,
+                    indices);
+    return;
+  }
+
+  // Same facing as the uniform grid (normal towards +y)
+  int cross = (bz - az) * (cx - ax) - (bx - ax) * (cz - az);
+  if (cross < 0) {
+    std::swap(bx, cx);
+    std::swap(bz, cz);
+  }
+  indices.push_back((unsigned short)(az * Verts + ax));
+  indices.push_back((unsigned short)(bz * Verts + bx));
+  indices.push_back((unsigned short)(cz * Verts + cx));
+}
+
+} // namespace
+
+void TerrainMesh::UpdateAdaptive(const Data::Terrain &terrain,
+                                 const Data::GridRegion &region, bool all) {
+  GENESIS_PROFILE_SCOPE("Mesh/Adaptive");
+  constexpr int Quads = ChunkQuads;
+  int gridWidth = chunksX * Quads + 1;
+  int gridDepth = chunksZ * Quads + 1;
+
+  // A new height multiplier marks the whole grid, which already redoes every
+  // error below
+  bool allErrors =
+      errors.size() != (size_t)gridWidth * gridDepth || !adaptive;
+  if (allErrors)
+    errors.assign((size_t)gridWidth * gridDepth, 0.0f);
+
+  MeshErrorGrid grid = {&terrain, heightMultiplier, gridWidth, gridDepth,
+                        errors.data()};
+
+  // A vertex's error only depends on heights inside its own chunk, plus the
+  // neighbouring chunk for vertices on a shared border. So the errors to redo
+  // are those of the touched chunks (borders included), and the chunks to
+  // re-triangulate are those plus their neighbours.
+  int cx0 = 0, cz0 = 0, cx1 = chunksX - 1, cz1 = chunksZ - 1;
+  if (allErrors) {
+    ComputeMeshErrors(grid, 0, 0, gridWidth - 1, gridDepth - 1);
+    all = true;
+  } else if (!region.IsEmpty()) {
+    cx0 = std::min(region.x0 / Quads, chunksX - 1);
+    cz0 = std::min(region.z0 / Quads, chunksZ - 1);
+    cx1 = std::min(region.x1 / Quads, chunksX - 1);
+    cz1 = std::min(region.z1 / Quads, chunksZ - 1);
+    ComputeMeshErrors(grid, cx0 * Quads, cz0 * Quads, (cx1 + 1) * Quads,
+                      (cz1 + 1) * Quads);
+  } else if (!all) {
+    return;
+  }
+
+  if (all) {
+    cx0 = 0;
+    cz0 = 0;
+    cx1 = chunksX - 1;
+    cz1 = chunksZ - 1;
+  } else {
+    cx0 = std::max(cx0 - 1, 0);
+    cz0 = std::max(cz0 - 1, 0);
+    cx1 = std::min(cx1 + 1, chunksX - 1);
+    cz1 = std::min(cz1 + 1, chunksZ - 1);
+  }
+
+  adaptiveChunks.resize(chunksX * chunksZ);
+  int rangeX = cx1 - cx0 + 1;
+  int rangeZ = cz1 - cz0 + 1;
+  maxError = settings.maxError;
+
+  Core::ThreadPool::Get().ParallelFor(rangeX * rangeZ, [&](int i) {
+    int cx = cx0 + i % rangeX;
+    int cz = cz0 + i / rangeX;
+    auto &indices = adaptiveChunks[cz * chunksX + cx].indices;
+    indices.clear();
+    // The chunk is two root triangles, split along the same diagonal that
+    // ComputeMeshErrors assumes for the chunk center
+    if ((cx + cz) % 2 == 0) {
+      TriangulateRtin(grid, cx * Quads, cz * Quads, maxError, 0, 0, Quads,
+                      Quads, Quads, 0, indices);
+      TriangulateRtin(grid, cx * Quads, cz * Quads, maxError, Quads, Quads, 0,
+                      0, 0, Quads, indices);
+    } else {
+      TriangulateRtin(grid, cx * Quads, cz * Quads, maxError, Quads, 0, 0,
+                      Quads, Quads, Quads, indices);
+      TriangulateRtin(grid, cx * Quads, cz * Quads, maxError, 0, Quads, Quads,
+                      0, 0, 0, indices);
+    }
+  });
+
+  // Keep the element buffers out of whatever VAO is bound
+  GENESIS_PROFILE_SCOPE("Mesh/Upload");
+  rlDisableVertexArray();
+  for (int cz = cz0; cz <= cz1; cz++) {
+    for (int cx = cx0; cx <= cx1; cx++) {
+      auto &chunk = adaptiveChunks[cz * chunksX + cx];
+      if (chunk.iboId != 0)
+        rlUnloadVertexBuffer(chunk.iboId);
+      chunk.iboId = rlLoadVertexBufferElement(
+          chunk.indices.data(),
+          (int)(chunk.indices.size() * sizeof(unsigned short)), false);
+    }
+  }
+
+  adaptive = true;
+}
+
+void TerrainMesh::UnloadAdaptive() {
+  for (auto &chunk : adaptiveChunks)
+    rlUnloadVertexBuffer(chunk.iboId);
+  adaptiveChunks.clear();
+  errors.clear();
+  adaptive = false;
+}
+
+void TerrainMesh::Unload() {
+  UnloadAdaptive();
+  if (!isLoaded)
+    return;
+  if (packed) {
+    for (auto &chunk : packedChunks) {
+      rlUnloadVertexArray(chunk.vaoId);
+      rlUnloadVertexBuffer(chunk.heightVboId);
+      rlUnloadVertexBuffer(chunk.attributeVboId);
+    }
+    packedChunks.clear();
+  } else {
+    // Also frees the CPU-side vertex arrays
+    UnloadModel(model);
+    model = {0};
+  }
+  isLoaded = false;
+}
+
+} // namespace Genesis::Render
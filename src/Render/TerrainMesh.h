@@ -0,0 +1,133 @@
+#pragma once
+
+#include "../Data/Terrain.h"
+#include "raylib.h"
+#include <vector>
+
+namespace Genesis::Render {
+
+// GPU-side mirror of a Data::Terrain: chunked vertex buffers, per-chunk height
+// ranges for culling, and optionally an adaptive triangulation. Update() keeps
+// it in sync with the terrain's dirty region, so generators never touch GL.
+class TerrainMesh {
+public:
+  // Quads per side of a mesh chunk. 128 quads = 129^2 vertices, which keeps
+  // each chunk within raylib's 16-bit index range.
+  static constexpr int ChunkQuads = 128;
+  static constexpr int ChunkVerts = ChunkQuads + 1;
+
+  struct Settings {
+    // Build chunks as PackedChunk (16-bit height, octahedral normal, palette
+    // index) instead of float/RGBA raylib meshes
+    bool packedVertices = false;
+    // Replace the uniform grid (and geomipmapping) with an error-bounded
+    // RTIN triangulation per chunk
+    bool adaptive = false;
+    float maxError = 0.05f; // World units
+    // The renderer applies height scale and sea level itself (GPU
+    // displacement), so changing only those leaves the CPU vertices alone
+    // until this is turned off again
+    bool displayOnGpu = false;
+  };
+
+  // Compact chunk vertex storage: 6 bytes per vertex instead of the 28 of a
+  // float position/normal + RGBA mesh. X and Z are implied by the vertex index
+  // within the chunk grid, so only the height is stored.
+  struct PackedChunk {
+    std::vector<unsigned short> heights; // Raw height quantized to 16 bits
+    // Per vertex: octahedral normal (x, y), palette index, unused
+    std::vector<unsigned char> attributes;
+
+    unsigned int vaoId = 0;
+    unsigned int heightVboId = 0;
+    unsigned int attributeVboId = 0;
+  };
+
+  // Index buffer for one chunk of the adaptive triangulation. Indices address
+  // the chunk's regular ChunkVerts x ChunkVerts vertex grid.
+  struct ChunkIndexBuffer {
+    std::vector<unsigned short> indices;
+    unsigned int iboId = 0;
+  };
+
+  // Terrain colors. Packed vertices store an index into this table; the
+  // packed shaders get the same table as a uniform array.
+  static constexpr int PaletteSize = 6;
+  static const Color Palette[PaletteSize];
+
+  static int GetPaletteIndex(float h, float seaLevel, int riverType);
+
+  TerrainMesh() = default;
+  ~TerrainMesh();
+
+  TerrainMesh(const TerrainMesh &) = delete;
+  TerrainMesh &operator=(const TerrainMesh &) = delete;
+
+  // Brings the buffers up to date with the terrain and clears its dirty
+  // region. When the grid size and settings are unchanged the existing
+  // buffers are updated in place, limited to terrain.dirty.
+  void Update(Data::Terrain &terrain);
+
+  // Releases GPU resources; call before the GL context goes away
+  void Unload();
+
+  Settings settings;
+
+  // --- State read by TerrainRenderer ---
+
+  // One mesh per chunk, row-major (chunksX * chunksZ). Either model or
+  // packedChunks holds the chunks, depending on packed.
+  Model model = {0};
+  std::vector<PackedChunk> packedChunks;
+  bool isLoaded = false;
+  bool packed = false;
+  int chunksX = 0;
+  int chunksZ = 0;
+  // Min/max raw height per chunk (x = min, y = max), for culling/LOD
+  std::vector<Vector2> chunkHeightRange;
+
+  // Adaptive triangulation, one entry per chunk when adaptive is set. errors
+  // holds the RTIN error of every vertex of the padded chunk grid
+  // ((chunksX * ChunkQuads + 1) per row) so edits only redo the chunks they
+  // touch.
+  std::vector<ChunkIndexBuffer> adaptiveChunks;
+  std::vector<float> errors;
+  bool adaptive = false;
+  float maxError = 0.0f;
+
+  // What the current buffers were built with
+  int width = 0;
+  int depth = 0;
+  float heightMultiplier = 0.0f;
+  float seaLevel = 0.0f;
+  // Terrain::scale. Vertices stay in grid units (the renderer scales x/z via
+  // the model matrix) but normals are built for world space.
+  float scale = 1.0f;
+
+  // Cells changed since the renderer last uploaded the height/river textures
+  // used by GPU displacement. Update forwards the terrain's region here.
+  Data::GridRegion textureDirty;
+
+private:
+  // (Re)creates the chunk meshes for the current grid size
+  void Allocate(const Data::Terrain &terrain, bool packedLayout);
+
+  static void UploadPackedChunk(PackedChunk &chunk);
+
+  // Writes positions/normals/colors for every chunk vertex inside region
+  void WriteVertices(const Data::Terrain &terrain,
+                     const Data::GridRegion &region);
+
+  // Recomputes the min/max raw height of one chunk
+  void UpdateChunkHeightRange(const Data::Terrain &terrain, int cx, int cz);
+
+  // Recomputes the RTIN vertex errors and chunk triangulations affected by
+  // region (or everything when `all` is set)
+  void UpdateAdaptive(const Data::Terrain &terrain,
+                      const Data::GridRegion &region, bool all);
+
+  // Drops the adaptive triangulation; chunks go back to the shared LOD grids
+  void UnloadAdaptive();
+};
+
+} // namespace Genesis::Render
@@ -0,0 +1,455 @@
+#include "TerrainRenderer.h"
+#include "../Core/Profiler.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Genesis::Render {
+
+namespace {
+
+constexpr int Quads = TerrainMesh::ChunkQuads;
+constexpr int Verts = Quads + 1;
+
+struct Plane {
+  float a, b, c, d;
+};
+
+// Gribb/Hartmann plane extraction. raylib matrices are column-major, so row r
+// of the combined matrix is (m[r], m[4 + r], m[8 + r], m[12 + r]).
+void ExtractFrustum(const Matrix &m, Plane planes[6]) {
+  planes[0] = {m.m3 + m.m0, m.m7 + m.m4, m.m11 + m.m8, m.m15 + m.m12};
+  planes[1] = {m.m3 - m.m0, m.m7 - m.m4, m.m11 - m.m8, m.m15 - m.m12};
+  planes[2] = {m.m3 + m.m1, m.m7 + m.m5, m.m11 + m.m9, m.m15 + m.m13};
+  planes[3] = {m.m3 - m.m1, m.m7 - m.m5, m.m11 - m.m9, m.m15 - m.m13};
+  planes[4] = {m.m3 + m.m2, m.m7 + m.m6, m.m11 + m.m10, m.m15 + m.m14};
+  planes[5] = {m.m3 - m.m2, m.m7 - m.m6, m.m11 - m.m10, m.m15 - m.m14};
+}
+
+bool IsBoxVisible(const Plane planes[6], const BoundingBox &box) {
+  for (int i = 0; i < 6; i++) {
+    const Plane &p = planes[i];
+    // Corner furthest along the plane normal
+    float x = p.a >= 0 ? box.max.x : box.min.x;
+    float y = p.b >= 0 ? box.max.y : box.min.y;
+    float z = p.c >= 0 ? box.max.z : box.min.z;
+    if (p.a * x + p.b * y + p.c * z + p.d < 0)
+      return false;
+  }
+  return true;
+}
+
+float DistanceToBox(Vector3 p, const BoundingBox &box) {
+  float dx = std::max({box.min.x - p.x, 0.0f, p.x - box.max.x});
+  float dy = std::max({box.min.y - p.y, 0.0f, p.y - box.max.y});
+  float dz = std::max({box.min.z - p.z, 0.0f, p.z - box.max.z});
+  return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+} // namespace
+
+TerrainRenderer::~TerrainRenderer() { Unload(); }
+
+void TerrainRenderer::Unload() {
+  for (auto &buffer : indexBuffers)
+    rlUnloadVertexBuffer(buffer.id);
+  indexBuffers.clear();
+  levelCount = 0;
+
+  if (flatGridVao != 0) {
+    rlUnloadVertexArray(flatGridVao);
+    rlUnloadVertexBuffer(flatGridVbo);
+    flatGridVao = 0;
+    flatGridVbo = 0;
+  }
+  if (heightTexture.id != 0)
+    UnloadTexture(heightTexture);
+  if (riverTexture.id != 0)
+    UnloadTexture(riverTexture);
+  heightTexture = {0};
+  riverTexture = {0};
+}
+
+void TerrainRenderer::LoadIndexBuffers() {
+  // Level l samples every 2^l-th vertex; stop while a coarser neighbour
+  // (step 2^(l+1)) still fits in a chunk
+  levelCount = 0;
+  while ((2 << levelCount) <= Quads)
+    levelCount++;
+
+  // Make sure no VAO picks up the element buffers we bind while creating them
+  rlDisableVertexArray();
+
+  indexBuffers.resize(levelCount * StitchCombinations);
+  std::vector<unsigned short> indices;
+
+  for (int level = 0; level < levelCount; level++) {
+    int step = 1 << level;
+    int coarse = step * 2;
+
+    for (int mask = 0; mask < StitchCombinations; mask++) {
+      // Vertices on a stitched edge snap down to the coarser neighbour's
+      // grid. That collapses the odd edge vertices into their even
+      // neighbours, so the edge matches the coarser chunk exactly.
+      auto vertex = [&](int lx, int lz) {
+        int sx = lx;
+        int sz = lz;
+        if ((lz == 0 && (mask & StitchNegZ)) ||
+            (lz == Quads && (mask & StitchPosZ)))
+          sx = lx / coarse * coarse;
+        if ((lx == 0 && (mask & StitchNegX)) ||
+            (lx == Quads && (mask & StitchPosX)))
+          sz = lz / coarse * coarse;
+        return (unsigned short)(sz * Verts + sx);
+      };
+
+      auto addTriangle = [&](unsigned short a, unsigned short b,
+                             unsigned short c) {
+        if (a == b || b == c || a == c)
+          return; // Collapsed by stitching
+        indices.push_back(a);
+        indices.push_back(b);
+        indices.push_back(c);
+      };
+
+      indices.clear();
+      for (int lz = 0; lz < Quads; lz += step) {
+        for (int lx = 0; lx < Quads; lx += step) {
+          unsigned short i00 = vertex(lx, lz);
+          unsigned short i10 = vertex(lx + step, lz);
+          unsigned short i01 = vertex(lx, lz + step);
+          unsigned short i11 = vertex(lx + step, lz + step);
+          // Same winding as the full resolution mesh
+          addTriangle(i00, i01, i10);
+          addTriangle(i01, i11, i10);
+        }
+      }
+
+      IndexBuffer &buffer = indexBuffers[level * StitchCombinations + mask];
+      buffer.count = (int)indices.size();
+      buffer.id = rlLoadVertexBufferElement(
+          indices.data(), (int)(indices.size() * sizeof(unsigned short)),
+          false);
+    }
+  }
+}
+
+void TerrainRenderer::LoadFlatGrid() {
+  // Local (x, z) of every chunk vertex, in the same order as the CPU chunk
+  // meshes so the LOD index buffers apply unchanged
+  std::vector<float> positions(Verts * Verts * 2);
+  for (int lz = 0; lz < Verts; lz++) {
+    for (int lx = 0; lx < Verts; lx++) {
+      positions[(lz * Verts + lx) * 2] = (float)lx;
+      positions[(lz * Verts + lx) * 2 + 1] = (float)lz;
+    }
+  }
+
+  flatGridVao = rlLoadVertexArray();
+  rlEnableVertexArray(flatGridVao);
+  flatGridVbo = rlLoadVertexBuffer(
+      positions.data(), (int)(positions.size() * sizeof(float)), false);
+  // Location 0 is where raylib binds "vertexPosition"
+  rlSetVertexAttribute(0, 2, RL_FLOAT, false, 0, 0);
+  rlEnableVertexAttribute(0);
+  rlDisableVertexArray();
+}
+
+void TerrainRenderer::SyncTextures(const Data::Terrain &terrain,
+                                   TerrainMesh &mesh) {
+  int width = terrain.width;
+  int depth = terrain.depth;
+
+  if (heightTexture.id == 0 || heightTexture.width != width ||
+      heightTexture.height != depth) {
+    if (heightTexture.id != 0)
+      UnloadTexture(heightTexture);
+    if (riverTexture.id != 0)
+      UnloadTexture(riverTexture);
+
+    // Created empty; the full upload below fills them
+    Image heights = {nullptr, width, depth, 1, PIXELFORMAT_UNCOMPRESSED_R32};
+    Image rivers = {nullptr, width, depth, 1,
+                    PIXELFORMAT_UNCOMPRESSED_GRAYSCALE};
+    heightTexture = LoadTextureFromImage(heights);
+    riverTexture = LoadTextureFromImage(rivers);
+    mesh.textureDirty = Data::GridRegion::Full(width, depth);
+  }
+
+  Data::GridRegion region = mesh.textureDirty;
+  if (region.IsEmpty())
+    return;
+
+  GENESIS_PROFILE_SCOPE("Render/TextureUpload");
+
+  // UpdateTextureRec wants the rectangle tightly packed
+  int regionWidth = region.x1 - region.x0 + 1;
+  int regionDepth = region.z1 - region.z0 + 1;
+  heightStaging.resize(regionWidth * regionDepth);
+  riverStaging.resize(regionWidth * regionDepth);
+  for (int z = region.z0; z <= region.z1; z++) {
+    int src = z * width + region.x0;
+    int dst = (z - region.z0) * regionWidth;
+    std::copy_n(&terrain.heightMap[src], regionWidth, &heightStaging[dst]);
+    // Same 8-bit values as the texture, so rows copy straight across
+    if (terrain.riverMap.Matches(width, depth))
+      std::copy_n(terrain.riverMap.Row(z) + region.x0, regionWidth,
+                  &riverStaging[dst]);
+    else
+      std::fill_n(&riverStaging[dst], regionWidth, (unsigned char)0);
+  }
+
+  Rectangle rect = {(float)region.x0, (float)region.z0, (float)regionWidth,
+                    (float)regionDepth};
+  UpdateTextureRec(heightTexture, rect, heightStaging.data());
+  UpdateTextureRec(riverTexture, rect, riverStaging.data());
+  mesh.textureDirty = {};
+}
+
+BoundingBox TerrainRenderer::GetChunkBounds(const TerrainMesh &mesh, int cx,
+                                            int cz, float heightScale) const {
+  // World space, so culling and LOD distances work the same for coarse
+  // (scaled) grids
+  Vector2 range = mesh.chunkHeightRange[cz * mesh.chunksX + cx];
+  float x0 = (float)(cx * Quads) * mesh.scale;
+  float z0 = (float)(cz * Quads) * mesh.scale;
+  float x1 = (float)std::min(cx * Quads + Quads, mesh.width - 1) * mesh.scale;
+  float z1 = (float)std::min(cz * Quads + Quads, mesh.depth - 1) * mesh.scale;
+  return {{x0, range.x * heightScale, z0}, {x1, range.y * heightScale, z1}};
+}
+
+void TerrainRenderer::SelectLevels(const TerrainMesh &mesh,
+                                   const Camera3D &camera, float heightScale) {
+  int chunksX = mesh.chunksX;
+  int chunksZ = mesh.chunksZ;
+  int maxLevel = std::clamp(settings.maxLevel, 0, levelCount - 1);
+
+  chunkLevels.assign(chunksX * chunksZ, 0);
+  if (!settings.lod || maxLevel == 0)
+    return;
+
+  // Distance based: each doubling of distance past lodDistance halves the
+  // grid resolution
+  for (int cz = 0; cz < chunksZ; cz++) {
+    for (int cx = 0; cx < chunksX; cx++) {
+      float distance = DistanceToBox(
+          camera.position, GetChunkBounds(mesh, cx, cz, heightScale));
+      int level = 0;
+      if (distance >= settings.lodDistance)
+        level = 1 + (int)std::log2(distance / settings.lodDistance);
+      chunkLevels[cz * chunksX + cx] = std::min(level, maxLevel);
+    }
+  }
+
+  // Stitching only handles neighbours one level apart, so pull down any chunk
+  // that is more than one level coarser than a neighbour. Levels only ever
+  // decrease, so this settles within maxLevel passes.
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int cz = 0; cz < chunksZ; cz++) {
+      for (int cx = 0; cx < chunksX; cx++) {
+        int &level = chunkLevels[cz * chunksX + cx];
+        int limit = level;
+        if (cx > 0)
+          limit = std::min(limit, chunkLevels[cz * chunksX + cx - 1] + 1);
+        if (cx < chunksX - 1)
+          limit = std::min(limit, chunkLevels[cz * chunksX + cx + 1] + 1);
+        if (cz > 0)
+          limit = std::min(limit, chunkLevels[(cz - 1) * chunksX + cx] + 1);
+        if (cz < chunksZ - 1)
+          limit = std::min(limit, chunkLevels[(cz + 1) * chunksX + cx] + 1);
+        if (limit < level) {
+          level = limit;
+          changed = true;
+        }
+      }
+    }
+  }
+}
+
+void TerrainRenderer::Draw(const TerrainMesh &mesh, const Camera3D &camera,
+                           Shader shader, Color tint, bool wireframe) {
+  stats = {};
+  if (!mesh.isLoaded)
+    return;
+
+  if (!mesh.packed) {
+    const Mesh *meshes = mesh.model.meshes;
+    DrawChunks(mesh, camera, shader, tint, wireframe, mesh.heightMultiplier,
+               [&](int chunk, int, int) {
+                 rlEnableVertexArray(meshes[chunk].vaoId);
+               });
+    return;
+  }
+
+  // Packed chunks only store heights; the shader rebuilds x/z from the vertex
+  // index and the chunk origin
+  int terrainSizeLoc = GetShaderLocation(shader, "terrainSize");
+  int heightScaleLoc = GetShaderLocation(shader, "heightScale");
+  int chunkOriginLoc = GetShaderLocation(shader, "chunkOrigin");
+  int terrainSize[2] = {mesh.width, mesh.depth};
+
+  rlEnableShader(shader.id);
+  rlSetUniform(terrainSizeLoc, terrainSize, RL_SHADER_UNIFORM_IVEC2, 1);
+  rlSetUniform(heightScaleLoc, &mesh.heightMultiplier, RL_SHADER_UNIFORM_FLOAT,
+               1);
+
+  const TerrainMesh::PackedChunk *chunks = mesh.packedChunks.data();
+  DrawChunks(mesh, camera, shader, tint, wireframe, mesh.heightMultiplier,
+             [&](int chunk, int cx, int cz) {
+               int origin[2] = {cx * Quads, cz * Quads};
+               rlSetUniform(chunkOriginLoc, origin, RL_SHADER_UNIFORM_IVEC2,
+                            1);
+               rlEnableVertexArray(chunks[chunk].vaoId);
+             });
+}
+
+void TerrainRenderer::DrawDisplaced(const Data::Terrain &terrain,
+                                    TerrainMesh &mesh, const Camera3D &camera,
+                                    Shader shader,
+                                    const DisplacementParams &params,
+                                    Color tint, bool wireframe) {
+  stats = {};
+  if (!mesh.isLoaded || terrain.heightMap.empty())
+    return;
+
+  if (flatGridVao == 0)
+    LoadFlatGrid();
+  SyncTextures(terrain, mesh);
+
+  int heightMapLoc = GetShaderLocation(shader, "heightMap");
+  int riverMapLoc = GetShaderLocation(shader, "riverMap");
+  int terrainSizeLoc = GetShaderLocation(shader, "terrainSize");
+  int heightScaleLoc = GetShaderLocation(shader, "heightScale");
+  int seaLevelLoc = GetShaderLocation(shader, "seaLevel");
+  int chunkOriginLoc = GetShaderLocation(shader, "chunkOrigin");
+  int cellSizeLoc = GetShaderLocation(shader, "cellSize");
+
+  int heightSlot = 1;
+  int riverSlot = 2;
+  int terrainSize[2] = {terrain.width, terrain.depth};
+
+  rlEnableShader(shader.id);
+  rlSetUniform(heightMapLoc, &heightSlot, RL_SHADER_UNIFORM_INT, 1);
+  rlSetUniform(riverMapLoc, &riverSlot, RL_SHADER_UNIFORM_INT, 1);
+  rlSetUniform(terrainSizeLoc, terrainSize, RL_SHADER_UNIFORM_IVEC2, 1);
+  rlSetUniform(heightScaleLoc, &params.heightMultiplier,
+               RL_SHADER_UNIFORM_FLOAT, 1);
+  rlSetUniform(seaLevelLoc, &params.seaLevel, RL_SHADER_UNIFORM_FLOAT, 1);
+  rlSetUniform(cellSizeLoc, &terrain.scale, RL_SHADER_UNIFORM_FLOAT, 1);
+
+  rlActiveTextureSlot(heightSlot);
+  rlEnableTexture(heightTexture.id);
+  rlActiveTextureSlot(riverSlot);
+  rlEnableTexture(riverTexture.id);
+
+  DrawChunks(mesh, camera, shader, tint, wireframe, params.heightMultiplier,
+             [&](int, int cx, int cz) {
+               int origin[2] = {cx * Quads, cz * Quads};
+               rlSetUniform(chunkOriginLoc, origin, RL_SHADER_UNIFORM_IVEC2,
+                            1);
+               rlEnableVertexArray(flatGridVao);
+             });
+
+  rlActiveTextureSlot(riverSlot);
+  rlDisableTexture();
+  rlActiveTextureSlot(heightSlot);
+  rlDisableTexture();
+  rlActiveTextureSlot(0);
+}
+
+template <typename BindChunk>
+void TerrainRenderer::DrawChunks(const TerrainMesh &mesh,
+                                 const Camera3D &camera, Shader shader,
+                                 Color tint, bool wireframe, float heightScale,
+                                 BindChunk bindChunk) {
+  if (indexBuffers.empty())
+    LoadIndexBuffers();
+
+  // Adaptive chunks carry their own triangulation, so LOD doesn't apply
+  bool adaptive = mesh.adaptive;
+  if (!adaptive)
+    SelectLevels(mesh, camera, heightScale);
+
+  int chunksX = mesh.chunksX;
+  int chunksZ = mesh.chunksZ;
+  stats.chunksTotal = chunksX * chunksZ;
+
+  // Vertices are in grid units; the model transform spreads them to world
+  // space. Normals are already built for world space, so the normal matrix
+  // stays identity. Chunk bounds are in world space too, so culling uses
+  // view * projection.
+  Matrix model = MatrixScale(mesh.scale, 1.0f, mesh.scale);
+  Matrix viewProjection =
+      MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+  Matrix mvp = MatrixMultiply(model, viewProjection);
+  Plane planes[6];
+  ExtractFrustum(viewProjection, planes);
+
+  Vector4 tintColor = ColorNormalize(tint);
+
+  rlEnableShader(shader.id);
+  rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], mvp);
+  rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MODEL], model);
+  rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_NORMAL], MatrixIdentity());
+  if (shader.locs[SHADER_LOC_COLOR_DIFFUSE] != -1)
+    rlSetUniform(shader.locs[SHADER_LOC_COLOR_DIFFUSE], &tintColor,
+                 RL_SHADER_UNIFORM_VEC4, 1);
+
+  if (wireframe)
+    rlEnableWireMode();
+
+  for (int cz = 0; cz < chunksZ; cz++) {
+    for (int cx = 0; cx < chunksX; cx++) {
+      int chunk = cz * chunksX + cx;
+      if (settings.frustumCulling &&
+          !IsBoxVisible(planes, GetChunkBounds(mesh, cx, cz, heightScale)))
+        continue;
+
+      if (adaptive) {
+        const TerrainMesh::ChunkIndexBuffer &indices =
+            mesh.adaptiveChunks[chunk];
+        int count = (int)indices.indices.size();
+        bindChunk(chunk, cx, cz);
+        rlEnableVertexBufferElement(indices.iboId);
+        rlDrawVertexArrayElements(0, count, 0);
+
+        stats.chunksDrawn++;
+        stats.trianglesDrawn += count / 3;
+        continue;
+      }
+
+      int level = chunkLevels[chunk];
+      int mask = 0;
+      if (cx > 0 && chunkLevels[chunk - 1] > level)
+        mask |= StitchNegX;
+      if (cx < chunksX - 1 && chunkLevels[chunk + 1] > level)
+        mask |= StitchPosX;
+      if (cz > 0 && chunkLevels[chunk - chunksX] > level)
+        mask |= StitchNegZ;
+      if (cz < chunksZ - 1 && chunkLevels[chunk + chunksX] > level)
+        mask |= StitchPosZ;
+
+      const IndexBuffer &buffer =
+          indexBuffers[level * StitchCombinations + mask];
+      bindChunk(chunk, cx, cz);
+      rlEnableVertexBufferElement(buffer.id);
+      rlDrawVertexArrayElements(0, buffer.count, 0);
+
+      stats.chunksDrawn++;
+      stats.trianglesDrawn += buffer.count / 3;
+    }
+  }
+
+  rlDisableVertexArray();
+  rlDisableVertexBufferElement();
+
+  if (wireframe)
+    rlDisableWireMode();
+
+  rlDisableShader();
+}
+
+} // namespace Genesis::Render
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "../Data/Terrain.h"
+#include "TerrainMesh.h"
+#include "raylib.h"
+#include <vector>
+
+namespace Genesis::Render {
+
+// Draws the chunked terrain with per-chunk frustum culling and geomipmapped
+// LOD. Every chunk shares one vertex layout, so a single set of index buffers
+// (per LOD level and per combination of coarser neighbours) serves all of
+// them. Seams are kept crack-free by limiting neighbouring chunks to one level
+// of difference and snapping the finer chunk's edge vertices onto the coarser
+// grid. Meshes with an adaptive triangulation (TerrainMesh::adaptive) draw
+// each chunk with its own index buffer instead.
+//
+// Two vertex sources are supported:
+// - the CPU-built chunk meshes (TerrainMesh::model, or packedChunks when
+//   packed is set; those need one of the packed shaders), or
+// - GPU displacement: one flat chunk-sized grid reused for every chunk and
+//   displaced in the vertex shader from height/river textures, so height
+//   scale and sea level are plain uniforms.
+class TerrainRenderer {
+public:
+  struct Settings {
+    bool frustumCulling = true;
+    bool lod = true;
+    float lodDistance = 160.0f; // Distance at which level 1 kicks in
+    int maxLevel = 5;           // Coarsest level (grid step 2^maxLevel)
+    bool gpuDisplacement = false;
+  };
+
+  struct Stats {
+    int chunksTotal = 0;
+    int chunksDrawn = 0;
+    int trianglesDrawn = 0;
+  };
+
+  // Inputs for the GPU displacement path that would otherwise be baked into
+  // vertices
+  struct DisplacementParams {
+    float heightMultiplier = 10.0f;
+    float seaLevel = 0.2f;
+  };
+
+  TerrainRenderer() = default;
+  ~TerrainRenderer();
+
+  TerrainRenderer(const TerrainRenderer &) = delete;
+  TerrainRenderer &operator=(const TerrainRenderer &) = delete;
+
+  // Draws the CPU-built chunk meshes. Must be called between
+  // BeginMode3D/EndMode3D. `tint` goes to the shader's colDiffuse (if any).
+  // Packed meshes also set the shader's terrainSize, heightScale and
+  // chunkOrigin uniforms.
+  void Draw(const TerrainMesh &mesh, const Camera3D &camera, Shader shader,
+            Color tint, bool wireframe);
+
+  // Draws the flat grid displaced by `shader` (see Application's displacement
+  // shader for the expected uniforms). Uploads whatever part of the height
+  // and river textures changed since the last call (mesh.textureDirty).
+  // The mesh only provides the chunk layout and height ranges.
+  void DrawDisplaced(const Data::Terrain &terrain, TerrainMesh &mesh,
+                     const Camera3D &camera, Shader shader,
+                     const DisplacementParams &params, Color tint,
+                     bool wireframe);
+
+  // Releases GPU resources; call before the GL context goes away
+  void Unload();
+
+  Settings settings;
+  const Stats &GetStats() const { return stats; }
+
+private:
+  // Bits marking chunk sides whose neighbour is one level coarser
+  enum StitchSide {
+    StitchNegX = 1,
+    StitchPosX = 2,
+    StitchNegZ = 4,
+    StitchPosZ = 8,
+  };
+  static constexpr int StitchCombinations = 16;
+
+  struct IndexBuffer {
+    unsigned int id = 0;
+    int count = 0;
+  };
+
+  void LoadIndexBuffers();
+  void LoadFlatGrid();
+  void SyncTextures(const Data::Terrain &terrain, TerrainMesh &mesh);
+
+  void SelectLevels(const TerrainMesh &mesh, const Camera3D &camera,
+                    float heightScale);
+  BoundingBox GetChunkBounds(const TerrainMesh &mesh, int cx, int cz,
+                             float heightScale) const;
+
+  // Shared culling/LOD/draw loop. bindChunk binds the vertex source for a
+  // chunk (VAO and any per-chunk uniforms).
+  template <typename BindChunk>
+  void DrawChunks(const TerrainMesh &mesh, const Camera3D &camera,
+                  Shader shader, Color tint, bool wireframe,
+                  float heightScale, BindChunk bindChunk);
+
+  int levelCount = 0;
+  std::vector<IndexBuffer> indexBuffers; // [level * 16 + stitch mask]
+  std::vector<int> chunkLevels;
+  Stats stats;
+
+  // GPU displacement resources
+  unsigned int flatGridVao = 0;
+  unsigned int flatGridVbo = 0;
+  Texture2D heightTexture = {0};
+  Texture2D riverTexture = {0};
+  std::vector<float> heightStaging;
+  std::vector<unsigned char> riverStaging;
+};
+
+} // namespace Genesis::Render
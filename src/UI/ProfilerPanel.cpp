@@ -0,0 +1,84 @@
+#include "ProfilerPanel.h"
+#include "../Core/Profiler.h"
+#include "raylib.h"
+#include <algorithm>
+
+namespace Genesis::UI {
+
+void ProfilerPanel::Draw(ImVec2 position) {
+  // Frame times are tracked even while stage profiling is off
+  frameTimes[frameIndex] = GetFrameTime() * 1000.0f;
+  frameIndex = (frameIndex + 1) % FrameHistory;
+
+  ImGui::SetNextWindowPos(position, ImGuiCond_FirstUseEver);
+  ImGui::SetNextWindowSize(ImVec2(320, 0), ImGuiCond_FirstUseEver);
+  if (!ImGui::Begin("Profiler")) {
+    ImGui::End();
+    return;
+  }
+
+  float average = 0.0f;
+  float worst = 0.0f;
+  for (float ms : frameTimes) {
+    average += ms;
+    worst = std::max(worst, ms);
+  }
+  average /= FrameHistory;
+  ImGui::Text("Frame: %.2f ms avg, %.2f ms max", average, worst);
+  ImGui::PlotLines("##frames", frameTimes, FrameHistory, frameIndex, nullptr,
+                   0.0f, std::max(worst, 33.3f), ImVec2(-1, 40));
+
+  auto &profiler = Core::Profiler::Get();
+  bool enabled = Core::Profiler::IsEnabled();
+  if (ImGui::Checkbox("Profile stages", &enabled))
+    Core::Profiler::SetEnabled(enabled);
+  ImGui::SameLine();
+  if (ImGui::Button("Reset"))
+    profiler.Reset();
+
+  auto stats = profiler.GetStats();
+  if (stats.empty()) {
+    ImGui::TextDisabled(enabled ? "No stages recorded yet."
+                                : "Enable to record generator stages.");
+  } else if (ImGui::BeginTable("Stages", 4,
+                               ImGuiTableFlags_RowBg |
+                                   ImGuiTableFlags_SizingStretchProp)) {
+    ImGui::TableSetupColumn("Stage");
+    ImGui::TableSetupColumn("Calls");
+    ImGui::TableSetupColumn("Last ms");
+    ImGui::TableSetupColumn("Avg ms");
+    ImGui::TableHeadersRow();
+    for (const auto &stat : stats) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(stat.name.c_str());
+      ImGui::TableNextColumn();
+      ImGui::Text("%d", stat.calls);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.2f", stat.lastMs);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.2f", stat.totalMs / stat.calls);
+    }
+    ImGui::EndTable();
+  }
+
+  ImGui::Separator();
+  ImGui::InputText("##trace", tracePath, sizeof(tracePath));
+  ImGui::SameLine();
+  if (ImGui::Button("Save Trace")) {
+    int count = profiler.GetEventCount();
+    if (profiler.WriteChromeTrace(tracePath))
+      status = "Wrote " + std::to_string(count) + " events";
+    else
+      status = "Could not write trace";
+    if (int dropped = profiler.GetDroppedCount())
+      status += " (" + std::to_string(dropped) + " dropped)";
+  }
+  if (!status.empty())
+    ImGui::TextUnformatted(status.c_str());
+  ImGui::TextDisabled("Open in chrome://tracing or ui.perfetto.dev");
+
+  ImGui::End();
+}
+
+} // namespace Genesis::UI
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "imgui.h"
+#include <string>
+
+namespace Genesis::UI {
+
+// Live view of Core::Profiler: enable toggle, frame time graph, per-stage
+// timings and Chrome trace export
+class ProfilerPanel {
+public:
+  // Call once per frame inside the ImGui frame; `position` is the window's
+  // initial top-left corner
+  void Draw(ImVec2 position);
+
+private:
+  static constexpr int FrameHistory = 120;
+  float frameTimes[FrameHistory] = {};
+  int frameIndex = 0;
+
+  char tracePath[128] = "genesis_trace.json";
+  std::string status;
+};
+
+} // namespace Genesis::UI
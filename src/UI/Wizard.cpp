@@ -4,7 +4,10 @@
 #include "../Generator/ErosionGenerator.h"
 #include "../Generator/RiverGenerator.h"
 #include "../Generator/TerrainGenerator.h"
+#include "../Generator/ThermalErosionGenerator.h"
+#include "raylib.h"
 #include <filesystem>
+#include <iterator>
 #include <map>
 #include <string>
 #include <vector>
@@ -22,12 +25,13 @@ const std::map<WizardStep, std::string> StepNames = {
     {WizardStep::Macro_Terrain, "1. Macro: Terrain"},
     {WizardStep::Rivers_Water, "2. Macro: Rivers"},
     {WizardStep::Macro_Erosion, "3. Macro: Erosion"},
-    {WizardStep::Infrastructure_Roads, "4. Infrastructure: Roads"},
-    {WizardStep::Zoning_Districts, "5. Zoning: Districts"},
-    {WizardStep::Parcels_Subdivision, "6. Parcels: Subdivision"},
-    {WizardStep::Buildings_Structure, "7. Buildings: Structure"},
-    {WizardStep::Interiors_Furnishing, "8. Interiors: Furnishing"},
-    {WizardStep::Export, "9. Export"}};
+    {WizardStep::Macro_Thermal, "4. Macro: Thermal Erosion"},
+    {WizardStep::Infrastructure_Roads, "5. Infrastructure: Roads"},
+    {WizardStep::Zoning_Districts, "6. Zoning: Districts"},
+    {WizardStep::Parcels_Subdivision, "7. Parcels: Subdivision"},
+    {WizardStep::Buildings_Structure, "8. Buildings: Structure"},
+    {WizardStep::Interiors_Furnishing, "9. Interiors: Furnishing"},
+    {WizardStep::Export, "10. Export"}};
 
 Wizard::Wizard() {}
 
@@ -36,14 +40,223 @@ void Wizard::Draw(std::shared_ptr<Genesis::Data::World> world,
   ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_FirstUseEver);
   ImGui::SetNextWindowSize(ImVec2(300, 600), ImGuiCond_FirstUseEver);
 
+  UpdateJob(*world);
+  UpdateLiveErosion(*world);
+
   if (ImGui::Begin("Genesis Wizard", nullptr,
                    ImGuiWindowFlags_MenuBar | ImGuiWindowFlags_NoCollapse)) {
     DrawMenuBar(project, world); // Draw Menu Bar
     DrawSidebar();
     ImGui::Separator();
+    DrawJobStatus();
+    // One job at a time; the step's controls come back when it's done.
+    // Preview jobs keep the terrain sliders live, and the other steps wait
+    // for the full-resolution terrain.
+    bool locked = currentStep == WizardStep::Macro_Terrain
+                      ? IsBusy() && previewJobLevel < 0
+                      : IsBusy() || previewLevel >= 0;
+    ImGui::BeginDisabled(locked);
     DrawCurrentStepFor(world, project);
+    ImGui::EndDisabled();
   }
   ImGui::End();
+
+  UpdatePreview(world, project);
+}
+
+void Wizard::StartJob(const char *name, Genesis::Data::World &world,
+                      bool copyTerrain, JobWork work,
+                      std::function<void()> onFinished) {
+  if (IsBusy())
+    return;
+
+  staging = std::make_shared<Genesis::Data::World>();
+  if (copyTerrain && world.terrain) {
+    *staging->terrain = *world.terrain;
+    *staging->riverNetwork = *world.riverNetwork;
+  }
+  onJobFinished = std::move(onFinished);
+  previewJobLevel = -1;
+
+  // The job owns a reference to the staging world; the live world is never
+  // touched off the main thread
+  job = std::make_unique<Genesis::Core::Job>(
+      name, [stagingWorld = staging, work = std::move(work)](
+                Genesis::Core::JobProgress &progress) {
+        work(*stagingWorld, progress);
+      });
+}
+
+void Wizard::GenerateTerrain(
+    Genesis::Data::World &world,
+    const Genesis::Generator::TerrainGenerator::Config &config,
+    std::function<void()> onFinished) {
+  // The tensor field lives outside the terrain, so it's resized with the swap
+  auto tensorField = world.tensorField;
+  StartJob(
+      "Generating terrain", world, false,
+      [config](Genesis::Data::World &staged,
+               Genesis::Core::JobProgress &progress) {
+        Genesis::Generator::TerrainGenerator::Generate(staged, config,
+                                                       &progress);
+      },
+      [tensorField, config, onFinished = std::move(onFinished)] {
+        if (tensorField)
+          tensorField->Resize(config.width, config.depth);
+        if (onFinished)
+          onFinished();
+      });
+}
+
+void Wizard::UpdateJob(Genesis::Data::World &world) {
+  if (!job || !job->IsDone())
+    return;
+
+  // A cancelled run leaves a half-written terrain behind; drop it
+  if (!job->IsCancelled()) {
+    world.terrain = staging->terrain;
+    world.riverNetwork = staging->riverNetwork;
+    if (onJobFinished)
+      onJobFinished();
+  }
+  job.reset();
+  staging.reset();
+  onJobFinished = {};
+  previewJobLevel = -1;
+}
+
+void Wizard::UpdateLiveErosion(Genesis::Data::World &world) {
+  if (erosionSession && erosionSession->GetTerrain() != world.terrain) {
+    erosionSession.reset();
+    erosionLive = false;
+  }
+  if (!erosionLive)
+    return;
+
+  erosionSession->Step(std::max(liveDropletsPerFrame, 1));
+  if (erosionSession->IsFinished()) {
+    erosionLive = false;
+    Genesis::Generator::TerrainGenerator::ApplyDisplaySettings(
+        world.terrain.get(), currentTerrainConfig);
+  }
+}
+
+void Wizard::UpdatePreview(std::shared_ptr<Genesis::Data::World> world,
+                           Genesis::Data::Project &project) {
+  using Genesis::Generator::TerrainGenerator;
+
+  // Applying display settings rebuilds every CPU vertex, so not on every
+  // frame of a drag (the GPU-displaced view follows the sliders directly)
+  if (previewDisplayPending && !ImGui::IsAnyItemActive()) {
+    TerrainGenerator::ApplyDisplaySettings(world->terrain.get(),
+                                           currentTerrainConfig);
+    previewDisplayPending = false;
+  }
+
+  if (!livePreview) {
+    StopPreview();
+    return;
+  }
+
+  double now = GetTime();
+  if (currentTerrainConfig != previewConfig) {
+    TerrainGenerator::Config displayOnly = previewConfig;
+    displayOnly.heightMultiplier = currentTerrainConfig.heightMultiplier;
+    displayOnly.seaLevel = currentTerrainConfig.seaLevel;
+    if (displayOnly == currentTerrainConfig) {
+      previewDisplayPending = true;
+    } else {
+      previewLevel = 0;
+      previewGeneration++;
+      previewChangedAt = now;
+      // A running coarse level is left to finish so dragging keeps showing
+      // something; finer levels are stale and go
+      if (previewJobLevel > 0)
+        job->Cancel();
+    }
+    previewConfig = currentTerrainConfig;
+  }
+
+  if (previewLevel < 0 || IsBusy())
+    return;
+  if (previewLevel == 0 ? now - previewStartedAt < PreviewInterval
+                        : now - previewChangedAt < PreviewSettle ||
+                              ImGui::IsAnyItemActive())
+    return;
+
+  int level = previewLevel;
+  int step = PreviewSteps[level];
+  bool last = level == (int)std::size(PreviewSteps) - 1;
+  int generation = previewGeneration;
+  TerrainGenerator::Config config = currentTerrainConfig;
+
+  // Display settings may change while the level runs
+  auto onFinished = [this, world, level, last, generation] {
+    TerrainGenerator::ApplyDisplaySettings(world->terrain.get(),
+                                           currentTerrainConfig);
+    if (generation == previewGeneration)
+      previewLevel = last ? -1 : level + 1;
+  };
+
+  if (last) {
+    GenerateTerrain(*world, config, [this, &project, onFinished, generation] {
+      onFinished();
+      if (generation != previewGeneration)
+        return;
+      Genesis::Data::Project::ConfigSnapshot snapshot;
+      snapshot.terrain = currentTerrainConfig;
+      snapshot.rivers = currentRiverConfig;
+      snapshot.erosion = currentErosionConfig;
+      snapshot.thermal = currentThermalConfig;
+      project.PushSnapshot(snapshot);
+    });
+  } else {
+    std::string name = "Preview 1/" + std::to_string(step);
+    StartJob(
+        name.c_str(), *world, false,
+        [config, step](Genesis::Data::World &staged,
+                       Genesis::Core::JobProgress &progress) {
+          TerrainGenerator::GeneratePreview(staged, config, step, &progress);
+        },
+        onFinished);
+  }
+  previewJobLevel = level;
+  previewStartedAt = now;
+}
+
+void Wizard::StopPreview() {
+  previewConfig = currentTerrainConfig;
+  previewLevel = -1;
+  previewGeneration++;
+}
+
+void Wizard::DrawJobStatus() {
+  if (erosionLive) {
+    ImGui::Text("Eroding live...");
+    ImGui::ProgressBar((float)erosionSession->GetDone() /
+                           erosionSession->GetTarget(),
+                       ImVec2(200, 0));
+    ImGui::SameLine();
+    if (ImGui::Button("Stop"))
+      erosionLive = false;
+    ImGui::Separator();
+    return;
+  }
+  if (!job)
+    return;
+
+  ImGui::Text("%s...", job->GetName().c_str());
+  ImGui::ProgressBar(job->GetProgress(), ImVec2(200, 0));
+  ImGui::SameLine();
+  ImGui::BeginDisabled(job->IsCancelled());
+  if (ImGui::Button("Cancel")) {
+    // Don't restart a cancelled preview until the sliders change again
+    if (previewJobLevel >= 0)
+      previewLevel = -1;
+    job->Cancel();
+  }
+  ImGui::EndDisabled();
+  ImGui::Separator();
 }
 
 // Modal State
@@ -69,6 +282,9 @@ void Wizard::DrawMenuBar(Genesis::Data::Project &project,
           // Capture current config
           Genesis::Data::Project::ConfigSnapshot snapshot;
           snapshot.terrain = currentTerrainConfig;
+          snapshot.rivers = currentRiverConfig;
+          snapshot.erosion = currentErosionConfig;
+          snapshot.thermal = currentThermalConfig;
           project.Save(project.path, snapshot);
         }
       }
@@ -83,22 +299,30 @@ void Wizard::DrawMenuBar(Genesis::Data::Project &project,
 
       ImGui::Separator();
 
-      if (ImGui::MenuItem("Undo", "Ctrl+Z", false, project.CanUndo())) {
+      if (ImGui::MenuItem("Undo", "Ctrl+Z", false,
+                          project.CanUndo() && !IsBusy())) {
         Genesis::Data::Project::ConfigSnapshot snapshot;
         if (project.Undo(snapshot)) {
-          Genesis::Generator::TerrainGenerator::Generate(*world,
-                                                         snapshot.terrain);
+          GenerateTerrain(*world, snapshot.terrain);
           // Sync UI
           currentTerrainConfig = snapshot.terrain;
+          currentRiverConfig = snapshot.rivers;
+          currentErosionConfig = snapshot.erosion;
+          currentThermalConfig = snapshot.thermal;
+          StopPreview();
         }
       }
-      if (ImGui::MenuItem("Redo", "Ctrl+Y", false, project.CanRedo())) {
+      if (ImGui::MenuItem("Redo", "Ctrl+Y", false,
+                          project.CanRedo() && !IsBusy())) {
         Genesis::Data::Project::ConfigSnapshot snapshot;
         if (project.Redo(snapshot)) {
-          Genesis::Generator::TerrainGenerator::Generate(*world,
-                                                         snapshot.terrain);
+          GenerateTerrain(*world, snapshot.terrain);
           // Sync UI
           currentTerrainConfig = snapshot.terrain;
+          currentRiverConfig = snapshot.rivers;
+          currentErosionConfig = snapshot.erosion;
+          currentThermalConfig = snapshot.thermal;
+          StopPreview();
         }
       }
 
@@ -141,6 +365,9 @@ void Wizard::DrawMenuBar(Genesis::Data::Project &project,
     if (ImGui::Button("Save", ImVec2(120, 0))) {
       Genesis::Data::Project::ConfigSnapshot snapshot;
       snapshot.terrain = currentTerrainConfig;
+      snapshot.rivers = currentRiverConfig;
+      snapshot.erosion = currentErosionConfig;
+      snapshot.thermal = currentThermalConfig;
 
       project.Save(inputFileName, snapshot);
       showSaveAsModal = false;
@@ -181,13 +408,19 @@ void Wizard::DrawMenuBar(Genesis::Data::Project &project,
 
     ImGui::InputText("Filename", inputFileName, 128);
 
-    if (ImGui::Button("Load", ImVec2(120, 0))) {
+    ImGui::BeginDisabled(IsBusy());
+    bool load = ImGui::Button("Load", ImVec2(120, 0));
+    ImGui::EndDisabled();
+    if (load) {
       Genesis::Data::Project::ConfigSnapshot snapshot;
       if (project.Load(inputFileName, snapshot)) {
-        Genesis::Generator::TerrainGenerator::Generate(*world,
-                                                       snapshot.terrain);
+        GenerateTerrain(*world, snapshot.terrain);
         // Update UI state
         currentTerrainConfig = snapshot.terrain;
+        currentRiverConfig = snapshot.rivers;
+        currentErosionConfig = snapshot.erosion;
+        currentThermalConfig = snapshot.thermal;
+        StopPreview();
 
         // Also restore history? For now just snapshot.
         project.PushSnapshot(snapshot);
@@ -230,6 +463,10 @@ void Wizard::DrawCurrentStepFor(std::shared_ptr<Genesis::Data::World> world,
   switch (currentStep) {
   case WizardStep::Macro_Terrain: {
     ImGui::Text("Terrain Settings");
+    // Turning it off mid-preview would leave a coarse terrain behind
+    ImGui::BeginDisabled(previewLevel >= 0);
+    ImGui::Checkbox("Live Preview", &livePreview);
+    ImGui::EndDisabled();
 
     ImGui::InputInt("Seed", &currentTerrainConfig.seed);
     if (ImGui::Button("Randomize Seed")) {
@@ -237,42 +474,69 @@ void Wizard::DrawCurrentStepFor(std::shared_ptr<Genesis::Data::World> world,
     }
 
     ImGui::Separator();
-    ImGui::SliderInt("Size", &currentTerrainConfig.width, 50, 500);
+    ImGui::SliderInt("Size", &currentTerrainConfig.width, 50, 4096);
     currentTerrainConfig.depth = currentTerrainConfig.width;
 
     ImGui::SliderFloat("Noise Scale", &currentTerrainConfig.noiseScale, 0.1f,
                        20.0f);
+    ImGui::SliderInt("Octaves", &currentTerrainConfig.octaves, 1, 10);
+    ImGui::SliderFloat("Lacunarity", &currentTerrainConfig.lacunarity, 1.5f,
+                       4.0f);
+    ImGui::SliderFloat("Gain", &currentTerrainConfig.gain, 0.1f, 0.9f);
     ImGui::SliderFloat("Height", &currentTerrainConfig.heightMultiplier, 1.0f,
                        50.0f);
     ImGui::SliderFloat("Sea Level", &currentTerrainConfig.seaLevel, 0.0f, 1.0f);
 
+    ImGui::BeginDisabled(IsBusy());
     if (ImGui::Button("Generate Terrain", ImVec2(280, 30))) {
-      Genesis::Generator::TerrainGenerator::Generate(*world,
-                                                     currentTerrainConfig);
-
-      if (world->tensorField)
-        world->tensorField->Resize(currentTerrainConfig.width,
-                                   currentTerrainConfig.depth);
-
-      // Record History
+      // Record History once the new terrain is in
       Genesis::Data::Project::ConfigSnapshot snapshot;
       snapshot.terrain = currentTerrainConfig;
-      project.PushSnapshot(snapshot);
+      snapshot.rivers = currentRiverConfig;
+      snapshot.erosion = currentErosionConfig;
+      snapshot.thermal = currentThermalConfig;
+      GenerateTerrain(*world, currentTerrainConfig,
+                      [&project, snapshot] { project.PushSnapshot(snapshot); });
+      StopPreview();
     }
+    ImGui::EndDisabled();
     break;
   }
   case WizardStep::Rivers_Water: {
     ImGui::Text("River Generation");
-    ImGui::TextWrapped("Click to sprout rivers from random high points.");
-
-    static Generator::RiverGenerator::Config riverConfig;
-    ImGui::SliderInt("River Count", &riverConfig.riverCount, 1, 50);
-    ImGui::SliderInt("Min Length", &riverConfig.minRiverLength, 5, 50);
-    ImGui::SliderFloat("Source H", &riverConfig.minSourceHeight, 0.0f, 1.0f);
+    ImGui::TextWrapped("Follow the water downhill: rivers form where enough "
+                       "of the map drains through, or sprout from random "
+                       "high points.");
+
+    auto &riverConfig = currentRiverConfig;
+    const char *methods[] = {"Flow Accumulation", "Trace"};
+    int method = (int)riverConfig.method;
+    if (ImGui::Combo("Method", &method, methods, IM_ARRAYSIZE(methods)))
+      riverConfig.method = (Genesis::Generator::RiverGenerator::Method)method;
+
+    if (riverConfig.method ==
+        Genesis::Generator::RiverGenerator::Method::FlowAccumulation) {
+      ImGui::SliderFloat("Min Catchment", &riverConfig.minCatchment, 0.0001f,
+                         0.05f, "%.4f", ImGuiSliderFlags_Logarithmic);
+      ImGui::InputInt("Min Lake Cells", &riverConfig.minLakeCells);
+      ImGui::SliderFloat("Width Scale", &riverConfig.widthScale, 0.0f, 0.05f,
+                         "%.4f");
+    } else {
+      ImGui::InputInt("River Seed", &riverConfig.seed);
+      ImGui::SliderInt("River Count", &riverConfig.riverCount, 1, 50);
+      ImGui::SliderInt("Min Length", &riverConfig.minRiverLength, 5, 50);
+      ImGui::SliderFloat("Source H", &riverConfig.minSourceHeight, 0.0f,
+                         1.0f);
+    }
 
     if (ImGui::Button("Generate Rivers", ImVec2(280, 30))) {
-      Genesis::Generator::RiverGenerator::Generate(*world, riverConfig,
-                                                   currentTerrainConfig);
+      StartJob("Generating rivers", *world, true,
+               [riverConfig, terrainConfig = currentTerrainConfig](
+                   Genesis::Data::World &staged,
+                   Genesis::Core::JobProgress &progress) {
+                 Genesis::Generator::RiverGenerator::Generate(
+                     staged, riverConfig, terrainConfig, &progress);
+               });
     }
 
     break;
@@ -281,18 +545,94 @@ void Wizard::DrawCurrentStepFor(std::shared_ptr<Genesis::Data::World> world,
     ImGui::Text("Hydraulic Erosion");
     ImGui::TextWrapped("Simulate rain to erode cliffs and smooth valleys.");
 
-    static Generator::ErosionGenerator::Config erosionConfig;
-    ImGui::InputInt("Iterations", &erosionConfig.iterations);
+    auto &erosionConfig = currentErosionConfig;
+    const char *methods[] = {"Droplets", "Grid (pipe model)"};
+    int method = (int)erosionConfig.method;
+    if (ImGui::Combo("Method", &method, methods, IM_ARRAYSIZE(methods)))
+      erosionConfig.method =
+          (Genesis::Generator::ErosionGenerator::Method)method;
+
+    bool grid = erosionConfig.method ==
+                Genesis::Generator::ErosionGenerator::Method::Grid;
+    if (grid) {
+      ImGui::InputInt("Steps", &erosionConfig.gridSteps);
+      ImGui::SliderFloat("Rain", &erosionConfig.rainRate, 0.0f, 0.01f,
+                         "%.4f");
+      ImGui::SliderFloat("Converge At", &erosionConfig.convergence, 0.0f,
+                         0.01f, "%.4f");
+    } else {
+      ImGui::InputInt("Erosion Seed", &erosionConfig.seed);
+      ImGui::InputInt("Iterations", &erosionConfig.iterations);
+    }
     ImGui::SliderFloat("Erosion", &erosionConfig.erosionRate, 0.0f, 1.0f);
     ImGui::SliderFloat("Deposit", &erosionConfig.depositionRate, 0.0f, 1.0f);
     ImGui::SliderFloat("Gravity", &erosionConfig.gravity, 1.0f, 20.0f);
-    ImGui::SliderFloat("Inertia", &erosionConfig.inertia, 0.0f, 1.0f);
+    if (!grid)
+      ImGui::SliderFloat("Inertia", &erosionConfig.inertia, 0.0f, 1.0f);
     ImGui::SliderFloat("Evap", &erosionConfig.evaporationRate, 0.001f, 0.2f);
     ImGui::SliderFloat("Min Slope", &erosionConfig.minSlope, 0.0f, 0.1f);
 
     if (ImGui::Button("Simulate Erosion", ImVec2(280, 30))) {
-      Genesis::Generator::ErosionGenerator::Execute(*world, erosionConfig,
-                                                    currentTerrainConfig);
+      // Droplet runs hand their session back so Continue can carry on
+      auto session = std::make_shared<std::shared_ptr<ErosionSession>>();
+      StartJob(
+          "Simulating erosion", *world, true,
+          [erosionConfig, terrainConfig = currentTerrainConfig,
+           session](Genesis::Data::World &staged,
+                    Genesis::Core::JobProgress &progress) {
+            if (erosionConfig.method ==
+                Genesis::Generator::ErosionGenerator::Method::Grid) {
+              Genesis::Generator::ErosionGenerator::Execute(
+                  staged, erosionConfig, terrainConfig, &progress);
+              return;
+            }
+            *session =
+                std::make_shared<ErosionSession>(staged.terrain, erosionConfig);
+            if ((*session)->Run(&progress))
+              Genesis::Generator::TerrainGenerator::ApplyDisplaySettings(
+                  staged.terrain.get(), terrainConfig);
+          },
+          [this, session] { erosionSession = *session; });
+    }
+
+    if (!grid) {
+      ImGui::Separator();
+      ImGui::Text("Live");
+      ImGui::InputInt("Droplets / Frame", &liveDropletsPerFrame, 500);
+      if (ImGui::Button("Run Live", ImVec2(280, 30))) {
+        erosionSession =
+            std::make_shared<ErosionSession>(world->terrain, erosionConfig);
+        erosionLive = true;
+      }
+      ImGui::InputInt("Droplets", &continueDroplets, 1000);
+      ImGui::BeginDisabled(!erosionSession);
+      if (ImGui::Button("Continue", ImVec2(280, 30))) {
+        erosionSession->Continue(continueDroplets);
+        erosionLive = true;
+      }
+      ImGui::EndDisabled();
+    }
+    break;
+  }
+  case WizardStep::Macro_Thermal: {
+    ImGui::Text("Thermal Erosion");
+    ImGui::TextWrapped("Let material slide off slopes steeper than the talus "
+                       "angle to soften cliffs.");
+
+    auto &thermalConfig = currentThermalConfig;
+    ImGui::InputInt("Iterations", &thermalConfig.iterations);
+    ImGui::SliderFloat("Talus Angle", &thermalConfig.talusAngle, 5.0f, 80.0f,
+                       "%.1f deg");
+    ImGui::SliderFloat("Rate", &thermalConfig.rate, 0.0f, 1.0f);
+
+    if (ImGui::Button("Simulate Thermal Erosion", ImVec2(280, 30))) {
+      StartJob("Simulating thermal erosion", *world, true,
+               [thermalConfig, terrainConfig = currentTerrainConfig](
+                   Genesis::Data::World &staged,
+                   Genesis::Core::JobProgress &progress) {
+                 Genesis::Generator::ThermalErosionGenerator::Execute(
+                     staged, thermalConfig, terrainConfig, &progress);
+               });
     }
     break;
   }
@@ -300,10 +640,19 @@ void Wizard::DrawCurrentStepFor(std::shared_ptr<Genesis::Data::World> world,
     ImGui::Text("Tensor Field Settings");
     static int tensorSeed = 12345;
     ImGui::InputInt("Tensor Seed", &tensorSeed);
+    ImGui::Checkbox("Align to Coast", &alignToCoast);
+    ImGui::Checkbox("Align to Rivers", &alignToRivers);
+    ImGui::SliderFloat("Align Spacing", &alignSpacing, 4.0f, 64.0f, "%.0f");
 
     if (ImGui::Button("Calculate Tensor Field")) {
-      if (world->tensorField)
-        world->tensorField->Generate(tensorSeed);
+      if (auto field = world->tensorField) {
+        field->Generate(tensorSeed);
+        if (alignToCoast && world->terrain)
+          field->AddCoastline(*world->terrain, alignSpacing);
+        if (alignToRivers && world->riverNetwork)
+          field->AddRivers(*world->riverNetwork, alignSpacing);
+        field->Evaluate();
+      }
     }
     break;
   }
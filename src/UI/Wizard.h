@@ -1,7 +1,12 @@
 #pragma once
 
+#include "../Core/Job.h"
+#include "../Generator/ErosionGenerator.h"
+#include "../Generator/RiverGenerator.h"
 #include "../Generator/TerrainGenerator.h"
+#include "../Generator/ThermalErosionGenerator.h"
 #include "imgui.h"
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -18,6 +23,7 @@ enum class WizardStep {
   Macro_Terrain,
   Rivers_Water,
   Macro_Erosion, // New step
+  Macro_Thermal,
   Infrastructure_Roads,
   Zoning_Districts,
   Parcels_Subdivision,
@@ -33,6 +39,12 @@ public:
   void Draw(std::shared_ptr<Genesis::Data::World> world,
             Genesis::Data::Project &project);
 
+  // Live terrain settings, including slider values not yet applied by
+  // Generate (used by the GPU-displaced renderer)
+  const Genesis::Generator::TerrainGenerator::Config &GetTerrainConfig() const {
+    return currentTerrainConfig;
+  }
+
 private:
   WizardStep currentStep = WizardStep::Macro_Terrain;
 
@@ -49,6 +61,90 @@ private:
 
   // Current Configuration State for UI
   Genesis::Generator::TerrainGenerator::Config currentTerrainConfig;
+  Genesis::Generator::RiverGenerator::Config currentRiverConfig;
+  Genesis::Generator::ErosionGenerator::Config currentErosionConfig;
+  Genesis::Generator::ThermalErosionGenerator::Config currentThermalConfig;
+  // Tensor field bases added along the coast/rivers, every alignSpacing
+  // world units
+  bool alignToCoast = true;
+  bool alignToRivers = true;
+  float alignSpacing = 16.0f;
+
+  // --- Background generation ---
+  // Generators run as a Core::Job on a private staging World, so the render
+  // thread never waits on them. When the job finishes, its terrain replaces
+  // the live one in a single pointer swap (on the main thread, between
+  // frames); viewers then upload whatever the job marked dirty.
+  using JobWork =
+      std::function<void(Genesis::Data::World &, Genesis::Core::JobProgress &)>;
+
+  // Starts `work` on a staging world. With copyTerrain the staging terrain
+  // starts as a copy of the live one (rivers/erosion build on it); otherwise
+  // it starts empty. onFinished runs on the main thread after the swap.
+  void StartJob(const char *name, Genesis::Data::World &world,
+                bool copyTerrain, JobWork work,
+                std::function<void()> onFinished = {});
+
+  // Regenerates the terrain from config as a job
+  void
+  GenerateTerrain(Genesis::Data::World &world,
+                  const Genesis::Generator::TerrainGenerator::Config &config,
+                  std::function<void()> onFinished = {});
+
+  // Swaps in the result of a finished job; call once per frame
+  void UpdateJob(Genesis::Data::World &world);
+
+  // Progress bar and cancel button while a job runs
+  void DrawJobStatus();
+
+  bool IsBusy() const { return job != nullptr || erosionLive; }
+
+  std::unique_ptr<Genesis::Core::Job> job;
+  std::shared_ptr<Genesis::Data::World> staging;
+  std::function<void()> onJobFinished;
+
+  // --- Live preview ---
+  // With livePreview on, terrain slider changes regenerate without pressing
+  // Generate: a coarse grid (every PreviewSteps[0]-th sample) follows the
+  // sliders while dragging, then each finer level runs once the drag ends,
+  // up to full resolution (which records the history snapshot). Height and
+  // sea level only rescale the current terrain.
+  static constexpr int PreviewSteps[] = {8, 4, 2, 1};
+  static constexpr double PreviewInterval = 0.05; // Min s between coarse runs
+  static constexpr double PreviewSettle = 0.3; // Idle s before refining
+
+  // Starts the next preview level when it's due; call once per frame
+  void UpdatePreview(std::shared_ptr<Genesis::Data::World> world,
+                     Genesis::Data::Project &project);
+  // Drops any pending levels (the current config is being applied some other
+  // way, e.g. Generate or Undo)
+  void StopPreview();
+
+  bool livePreview = true;
+  Genesis::Generator::TerrainGenerator::Config previewConfig;
+  // Height/sea level changed; applied to the terrain once the drag ends
+  bool previewDisplayPending = false;
+  int previewLevel = -1;     // Next PreviewSteps index to run, -1 when idle
+  int previewJobLevel = -1;  // Level of the running job, -1 if not a preview
+  int previewGeneration = 0; // Bumped on every config change
+  double previewChangedAt = 0.0;
+  double previewStartedAt = 0.0;
+
+  // --- Live erosion ---
+  // "Run Live" erodes the live terrain a slice of droplets per frame, on the
+  // main thread between draws, so the mesh follows along as it changes.
+  // Stop ends it early; Continue adds droplets to the last droplet run
+  // (live or not) without restoring the pre-erosion snapshot. The session
+  // is dropped once its terrain is replaced.
+  using ErosionSession = Genesis::Generator::ErosionGenerator::Session;
+
+  // Runs this frame's slice; call once per frame
+  void UpdateLiveErosion(Genesis::Data::World &world);
+
+  std::shared_ptr<ErosionSession> erosionSession;
+  bool erosionLive = false;
+  int liveDropletsPerFrame = 2000;
+  int continueDroplets = 10000;
 };
 
 } // namespace Genesis::UI